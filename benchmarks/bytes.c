@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "utilities/bytes.h"
+
+// Measures the throughput of every hashing kernel this CPU supports, over
+// strings from 8 bytes to 1MB, next to the memcmp that compares strings.
+// Before timing a size, it checks that every kernel computes the same hash,
+// since the interpreter picks a kernel at run time and hashes are stored in
+// bytecode caches.
+
+#define SMALLEST 8
+#define LARGEST ( 1024 * 1024 )
+
+#define DEFAULT_VOLUME ( 256 * 1024 * 1024 )
+
+static volatile uint64_t sink;
+
+static double now() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static bool check(const Kernel* kernels, int count, const char* content, int length) {
+  for (int i = 0; i < count; i++)
+    if (kernels[i].hash(content, length) != kernels[0].hash(content, length))
+      return false;
+
+  return hashing(content, length) == kernels[0].hash(content, length);
+}
+
+static double hash_rate(const Kernel* kernel, const char* content, int length, long runs) {
+  uint64_t total = 0;
+
+  double start = now();
+
+  for (long i = 0; i < runs; i++)
+    total += kernel->hash(content, length);
+
+  double elapsed = now() - start;
+
+  sink = total;
+
+  return (double)length * runs / elapsed / 1e9;
+}
+
+static double compare_rate(const char* left, const char* right, int length, long runs) {
+  int (*volatile compare)(const void*, const void*, size_t) = memcmp;
+
+  uint64_t total = 0;
+
+  double start = now();
+
+  for (long i = 0; i < runs; i++)
+    total += compare(left, right, length) == 0;
+
+  double elapsed = now() - start;
+
+  sink = total;
+
+  return (double)length * runs / elapsed / 1e9;
+}
+
+int main(int argc, const char* argv[]) {
+  long volume = argc > 1 ? atol(argv[1]) : DEFAULT_VOLUME;
+
+  if (volume <= 0) {
+    fprintf(stderr, "The correct syntax is: bytes [bytes per measurement]\n");
+    return 64;
+  }
+
+  int count;
+
+  const Kernel* list = kernels(&count);
+
+  char* left = malloc(LARGEST);
+  char* right = malloc(LARGEST);
+
+  if (left == NULL || right == NULL) return 1;
+
+  srand(42);
+
+  for (int i = 0; i < LARGEST; i++)
+    left[i] = right[i] = (char)(rand() & 0xff);
+
+  printf("Selected kernel: %s. Throughputs are in GB/s.\n\n", kernel()->name);
+
+  printf("%10s", "Size");
+
+  for (int i = 0; i < count; i++)
+    printf(" %8s hash", list[i].name);
+
+  printf(" %14s\n", "memcmp");
+
+  for (int length = SMALLEST; length <= LARGEST; length *= 2) {
+    if (check(list, count, left, length) == false) {
+      fprintf(stderr, "The kernels disagree on %d bytes.\n", length);
+      return 1;
+    }
+
+    long runs = volume / length;
+
+    printf("%10d", length);
+
+    for (int i = 0; i < count; i++)
+      printf(" %13.2f", hash_rate(&list[i], left, length, runs));
+
+    printf(" %14.2f\n", compare_rate(left, right, length, runs));
+  }
+
+  free(left);
+  free(right);
+
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Builds the interpreter twice, once per set of CMake flags, and runs every
+# benchmark of this folder against both builds, side by side. Setting
+# REVISION builds the baseline from that git revision instead of the
+# working tree.
+#
+# Usage: benchmarks/compare.sh "<baseline flags>" "<candidate flags>"
+# Example: benchmarks/compare.sh "" "-DNAN_BOXING=ON"
+# Example: REVISION=HEAD~1 benchmarks/compare.sh
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+
+BASELINE=${1:-}
+CANDIDATE=${2:-}
+
+WORKSPACE=${WORKSPACE:-"$ROOT/build-compare"}
+
+build() {
+  SOURCE=$ROOT
+
+  if [ "$1" = "baseline" ] && [ -n "${REVISION:-}" ]; then
+    SOURCE="$WORKSPACE/revision"
+
+    rm -rf "$SOURCE"
+    mkdir -p "$SOURCE"
+
+    git -C "$ROOT" archive "$REVISION" | tar -x -C "$SOURCE"
+  fi
+
+  cmake -S "$SOURCE" -B "$WORKSPACE/$1" -DCMAKE_BUILD_TYPE=Release $2 > /dev/null
+  cmake --build "$WORKSPACE/$1" > /dev/null
+}
+
+measure() {
+  START=$(date +%s.%N)
+  "$WORKSPACE/$1/elite" "$2" > /dev/null
+  STOP=$(date +%s.%N)
+  awk "BEGIN { printf \"%.3f\", $STOP - $START }"
+}
+
+build baseline "$BASELINE"
+build candidate "$CANDIDATE"
+
+printf "%-24s %12s %12s\n" "Benchmark" "Baseline" "Candidate"
+
+for BENCHMARK in "$ROOT"/benchmarks/*.eli; do
+  printf "%-24s %12s %12s\n" "$(basename "$BENCHMARK")" \
+    "$(measure baseline "$BENCHMARK")" "$(measure candidate "$BENCHMARK")"
+done
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "elite.h"
+
+// Runs one VM per thread, each executing the same script over and over, and
+// reports the total throughput for every number of threads up to the given
+// one. Every run checks its own result, so VMs that shared any state would
+// show up as wrong results rather than only as slower ones.
+
+#define DEFAULT_THREADS 8
+#define DEFAULT_RUNS 50
+
+#define SCRIPT \
+  "define fibonacci(n) { if n < 2: return n; return fibonacci(n - 1) + fibonacci(n - 2); }\n" \
+  "class Point { set x: 0, y: 0; define Point(x, y) { this.x = x; this.y = y; } }\n" \
+  "set total: 0;\n" \
+  "for (set i: 0; i < 2000; i++) { set point: Point(i, seed); total = total + point.x + point.y; }\n" \
+  "set text: \"\";\n" \
+  "for (set i: 0; i < 200; i++) text = text + \"x\";\n" \
+  "result = fibonacci(18) + total + length(text);\n"
+
+typedef struct {
+  int seed, runs;
+
+  bool failed;
+} Worker;
+
+static double now() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static void* work(void* argument) {
+  Worker* worker = argument;
+
+  VM* vm = create_VM(NULL);
+
+  set_global(vm, "seed", INTEGER(worker->seed));
+  set_global(vm, "result", VOID);
+
+  Function* script = load_script(vm, SCRIPT);
+
+  int64_t expected = 2584 + 1999000 + 2000 * (int64_t)worker->seed + 200;
+
+  for (int i = 0; i < worker->runs && script != NULL; i++) {
+    Value result;
+
+    if (execute(vm, script) != INTERPRET_OK ||
+        get_global(vm, "result", &result) == false ||
+        IS_INTEGER(result) == false || AS_INTEGER(result) != expected) {
+      worker->failed = true;
+      break;
+    }
+  }
+
+  if (script == NULL) worker->failed = true;
+
+  unload_script(vm, script);
+
+  destroy_VM(vm);
+
+  return NULL;
+}
+
+int main(int argc, const char* argv[]) {
+  int threads = argc > 1 ? atoi(argv[1]) : DEFAULT_THREADS;
+  int runs = argc > 2 ? atoi(argv[2]) : DEFAULT_RUNS;
+
+  if (threads <= 0 || runs <= 0) {
+    fprintf(stderr, "The correct syntax is: threads [threads] [runs]\n");
+    return 64;
+  }
+
+  pthread_t* identifiers = malloc(sizeof(pthread_t) * threads);
+  Worker* workers = malloc(sizeof(Worker) * threads);
+
+  double single = 0;
+
+  bool failed = false;
+
+  printf("%-8s %12s %10s\n", "Threads", "Runs/second", "Scaling");
+
+  for (int count = 1; count <= threads; count *= 2) {
+    double start = now();
+
+    for (int i = 0; i < count; i++) {
+      workers[i] = (Worker){ i, runs, false };
+      pthread_create(&identifiers[i], NULL, work, &workers[i]);
+    }
+
+    for (int i = 0; i < count; i++) {
+      pthread_join(identifiers[i], NULL);
+      failed = failed || workers[i].failed;
+    }
+
+    double throughput = count * runs / (now() - start);
+
+    if (count == 1) single = throughput;
+
+    printf("%-8d %12.1f %9.2fx\n", count, throughput, throughput / single);
+
+    if (count < threads && count * 2 > threads) count = threads / 2;
+  }
+
+  free(identifiers);
+  free(workers);
+
+  if (failed == true) {
+    fprintf(stderr, "A VM returned a wrong result.\n");
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,43 @@
+#!/bin/sh
+#
+# Builds the interpreter twice, once as usual and once counting every
+# dispatched instruction, then runs every benchmark of this folder on the
+# stack-based and on the register-based (-r) instruction set, side by side.
+#
+# Usage: benchmarks/tiers.sh ["<extra CMake flags>"]
+# Example: benchmarks/tiers.sh "-DNAN_BOXING=ON"
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+
+FLAGS=${1:-}
+
+WORKSPACE=${WORKSPACE:-"$ROOT/build-tiers"}
+
+build() {
+  cmake -S "$ROOT" -B "$WORKSPACE/$1" -DCMAKE_BUILD_TYPE=Release $FLAGS $2 > /dev/null
+  cmake --build "$WORKSPACE/$1" > /dev/null
+}
+
+measure() {
+  START=$(date +%s.%N)
+  "$WORKSPACE/timing/elite" "$1" $2 > /dev/null
+  STOP=$(date +%s.%N)
+  awk "BEGIN { printf \"%.3f\", $STOP - $START }"
+}
+
+count() {
+  "$WORKSPACE/counting/elite" "$1" $2 2>&1 > /dev/null | awk '/^Instructions:/ { print $2 }'
+}
+
+build timing ""
+build counting "-DCOUNT_INSTRUCTIONS=ON"
+
+printf "%-24s %12s %12s %14s %14s\n" "Benchmark" "Stack" "Register" "Stack ops" "Register ops"
+
+for BENCHMARK in "$ROOT"/benchmarks/*.eli; do
+  printf "%-24s %12s %12s %14s %14s\n" "$(basename "$BENCHMARK")" \
+    "$(measure "$BENCHMARK")" "$(measure "$BENCHMARK" -r)" \
+    "$(count "$BENCHMARK")" "$(count "$BENCHMARK" -r)"
+done
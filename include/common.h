@@ -11,7 +11,9 @@
 
 #define NULL_TERMINATOR '\0'
 
-#define GMP_MAX_PRECISION 100024
+#define GMP_DEFAULT_PRECISION 100024
+
+#define GMP_IMMEDIATE_PRECISION 64
 
 extern const char* compile_time_errors[];
 extern const char* run_time_errors[];
@@ -59,6 +59,8 @@ typedef struct Compiler {
   int count;
   int scope;
 
+  int operand, literal, store, label;
+
   Up ups[MAXIMUM_LIMIT];
 } Compiler;
 
@@ -84,6 +86,6 @@ typedef struct {
   Precedences precedence;
 } Rule;
 
-Function* compile(VM* vm, const char* source);
+Function* compile(VM* vm, const char* source, size_t length);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef ELITE_H
+#define ELITE_H
+
+// The embedding API. Every VM owns all of its state, so separate VMs can run
+// on separate threads at the same time; a single VM, and the Values it
+// returns, must only be used by one thread at a time.
+
+#include "common.h"
+
+#include "vm.h"
+#include "types/object.h"
+#include "natives/handler.h"
+#include "natives/functions.h"
+
+// Allocates and initializes a VM, with the default settings when NULL.
+VM* create_VM(Settings* settings);
+void destroy_VM(VM* vm);
+
+// Compiles a script once and keeps it alive until it is unloaded, so that
+// execute() can run it any number of times. Returns NULL on compile errors.
+Function* load_script(VM* vm, const char* source);
+void unload_script(VM* vm, Function* script);
+
+// Defines or replaces the global variable with the given identifier.
+void set_global(VM* vm, const char* identifier, Value value);
+
+// Returns false when no global variable with the given identifier is defined.
+bool get_global(VM* vm, const char* identifier, Value* value);
+
+#endif
@@ -2,6 +2,8 @@
 #ifndef GENERIC_H
 #define GENERIC_H
 
+#include <stddef.h>
+
 enum {
   CLASS_CAN_SET_DEFINE,
   CANNOT_INHERIT_SELF,
@@ -42,8 +44,10 @@ enum {
   MINIMUM_CAPACITY_LOOP_BODY,
   MUST_HAVE_SUPERCLASS,
   TOO_MANY_CONSTANTS,
+  TOO_MANY_CACHES,
   TOO_MANY_LOCALS,
   TOO_MANY_CLOSURE_VARIABLES,
+  TOO_MANY_GLOBALS,
   VARIABLE_ALREADY_DECLARE
 };
 
@@ -60,19 +64,26 @@ enum {
   MUST_BE_STRINGS,
   MUST_BE_NUMBER_OR_STRING,
   MUST_BE_NUMBERS_OR_STRINGS,
+  MUST_BE_POSITIVE_INTEGER,
   STACK_OVERFLOW,
   UNDEFINED_VARIABLE,
   UNDEFINED_ERROR,
   UNDEFINED_METHOD,
-  UNDEFINED_PROPERTY
+  UNDEFINED_PROPERTY,
+  UNDEFINED_STATISTIC,
+  UNDEFINED_COUNTER,
+  UNDEFINED_TABLE,
+  UNDEFINED_PROBE
 };
 
 enum {
   CANNOT_OPEN_FILE,
   CANNOT_READ_FILE,
+  CANNOT_WRITE_FILE,
   NOT_ENOUGH_MEMORY
 };
 
-char* read(const char* path, int* error);
+const char* map_file(const char* path, size_t* size, int* error);
+void unmap_file(const char* content, size_t size);
 
 #endif
\ No newline at end of file
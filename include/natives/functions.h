@@ -15,5 +15,11 @@ Value print_native(int count, Value* arguments, Handler* handler);
 Value input_native(int count, Value* arguments, Handler* handler);
 Value length_native(int count, Value* arguments, Handler* handler);
 Value type_native(int count, Value* arguments, Handler* handler);
+Value precision_native(int count, Value* arguments, Handler* handler);
+Value big_native(int count, Value* arguments, Handler* handler);
+Value collector_native(int count, Value* arguments, Handler* handler);
+Value caches_native(int count, Value* arguments, Handler* handler);
+Value probes_native(int count, Value* arguments, Handler* handler);
+Value builder_native(int count, Value* arguments, Handler* handler);
 
 #endif
\ No newline at end of file
@@ -15,6 +15,7 @@ typedef struct Prototypes {
   Prototype object;
   Prototype number;
   Prototype string;
+  Prototype builder;
 } Prototypes;
 
 void load_default_native_methods(VM* vm);
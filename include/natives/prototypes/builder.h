@@ -0,0 +1,13 @@
+#ifndef PROTOTYPES_BUILDER_H
+#define PROTOTYPES_BUILDER_H
+
+#include "common.h"
+
+#include "natives/handler.h"
+
+Value append_builder_method(Value receiver, int count, Value* arguments, Handler* handler);
+Value build_builder_method(Value receiver, int count, Value* arguments, Handler* handler);
+Value length_builder_method(Value receiver, int count, Value* arguments, Handler* handler);
+Value clear_builder_method(Value receiver, int count, Value* arguments, Handler* handler);
+
+#endif
\ No newline at end of file
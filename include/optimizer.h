@@ -0,0 +1,10 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "common.h"
+
+#include "utilities/chunk.h"
+
+void optimize(Chunk* chunk);
+
+#endif
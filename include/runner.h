@@ -0,0 +1,35 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include <pthread.h>
+
+#include "common.h"
+
+#include "vm.h"
+
+#define EXIT_COMPILE_ERROR 65
+#define EXIT_RUNTIME_ERROR 70
+#define EXIT_FILE_ERROR 74
+
+typedef struct {
+  const char* path;
+
+  int code;
+
+  double time, cpu;
+} Job;
+
+typedef struct {
+  pthread_mutex_t lock;
+
+  int top, bottom;
+} Deque;
+
+int run_file(VM* vm, const char* path);
+int compile_file(VM* vm, const char* path);
+
+int compile_files(Settings* settings, const char** paths, int count);
+
+int run_jobs(Settings* settings, const char** paths, int count, int workers, bool emit);
+
+#endif
@@ -36,10 +36,11 @@ typedef struct {
 typedef struct {
   const char* start;
   const char* current;
+  const char* end;
   int line;
 } Tokenizer;
 
-void set_tokenizer(Tokenizer* tokenizer, const char* source);
+void set_tokenizer(Tokenizer* tokenizer, const char* source, size_t length);
 
 Token scan(Tokenizer* tokenizer);
 
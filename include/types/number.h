@@ -0,0 +1,86 @@
+#ifndef NUMBER_H
+#define NUMBER_H
+
+#include <math.h>
+
+#include "common.h"
+
+#include "types/value.h"
+
+typedef enum {
+  ARITHMETIC_ADD,
+  ARITHMETIC_SUBTRACT,
+  ARITHMETIC_MULTIPLY,
+  ARITHMETIC_DIVIDE,
+  ARITHMETIC_POWER
+} Arithmetics;
+
+Value parse_number(VM* vm, const char* content);
+Value intern_number(VM* vm, const char* content, int length);
+
+Value normalize_number(VM* vm, mpf_t value);
+Value normalize_double(double value);
+
+void to_gmp(Value value, mpf_t result);
+double to_double(Value value);
+
+Value arithmetic(VM* vm, Arithmetics operation, Value left, Value right);
+Value negation(VM* vm, Value value);
+
+int compare_numbers(Value left, Value right);
+
+bool zero(Value value);
+
+static inline bool integer_arithmetic(Arithmetics operation, int64_t left, int64_t right, int64_t* result) {
+  switch (operation) {
+    case ARITHMETIC_ADD: 
+      if (__builtin_add_overflow(left, right, result)) return false; 
+      break;
+
+    case ARITHMETIC_SUBTRACT: 
+      if (__builtin_sub_overflow(left, right, result)) return false; 
+      break;
+
+    case ARITHMETIC_MULTIPLY: 
+      if (__builtin_mul_overflow(left, right, result)) return false; 
+      break;
+
+    case ARITHMETIC_DIVIDE:
+      if (right == 0 || (left == INT64_MIN && right == -1) || left % right != 0) return false;
+      *result = left / right;
+      break;
+
+    case ARITHMETIC_POWER: {
+      if (right < 0) return false;
+
+      int64_t base = left, power = 1;
+
+      while (right > 0) {
+        if ((right & 1) && __builtin_mul_overflow(power, base, &power)) return false;
+
+        right >>= 1;
+
+        if (right > 0 && __builtin_mul_overflow(base, base, &base)) return false;
+      }
+
+      *result = power;
+      break;
+    }
+  }
+
+  return FITS_INTEGER(*result);
+}
+
+static inline double double_arithmetic(Arithmetics operation, double left, double right) {
+  switch (operation) {
+    case ARITHMETIC_ADD: return left + right;
+    case ARITHMETIC_SUBTRACT: return left - right;
+    case ARITHMETIC_MULTIPLY: return left * right;
+    case ARITHMETIC_DIVIDE: return left / right;
+    case ARITHMETIC_POWER: return pow(left, right);
+  }
+
+  return 0.0;
+}
+
+#endif
@@ -10,8 +10,12 @@
 #include "utilities/chunk.h"
 #include "types/value.h"
 
-#define IS_NUMBER(value) validate(value, OBJECT_NUMBER)
+#define IS_NUMBER(value) numeric(value)
+#define IS_NUMBER_OBJECT(value) validate(value, OBJECT_NUMBER)
 #define IS_STRING(value) validate(value, OBJECT_STRING)
+#define IS_ROPE(value) validate(value, OBJECT_ROPE)
+#define IS_TEXT(value) textual(value)
+#define IS_BUILDER(value) validate(value, OBJECT_BUILDER)
 #define IS_UPVALUE(value) validate(value, OBJECT_UPVALUE)
 #define IS_FUNCTION(value) validate(value, OBJECT_FUNCTION)
 #define IS_CLOSURE(value) validate(value, OBJECT_CLOSURE)
@@ -24,6 +28,8 @@
 
 #define AS_NUMBER(value) ( (Number*)AS_OBJECT(value) )
 #define AS_STRING(value) ( (String*)AS_OBJECT(value) )
+#define AS_ROPE(value) ( (Rope*)AS_OBJECT(value) )
+#define AS_BUILDER(value) ( (Builder*)AS_OBJECT(value) )
 #define AS_UPVALUE(value) ( (Upvalue*)AS_OBJECT(value) )
 #define AS_FUNCTION(value) ( (Function*)AS_OBJECT(value) )
 #define AS_CLOSURE(value) ( (Closure*)AS_OBJECT(value) )
@@ -36,9 +42,13 @@
 
 #define OBJECT_TYPE(value) ( AS_OBJECT(value)->type )
 
+#define ROPE_MINIMUM_LENGTH 256
+
 typedef enum {
   OBJECT_NUMBER,
   OBJECT_STRING,
+  OBJECT_ROPE,
+  OBJECT_BUILDER,
   OBJECT_UPVALUE,
   OBJECT_FUNCTION,
   OBJECT_CLOSURE,
@@ -54,7 +64,7 @@ typedef struct Object {
   Objects type;
   Prototype* prototype;
   struct Object* next;
-  bool mark;
+  bool mark, old, remembered;
 } Object;
 
 typedef struct Number {
@@ -67,8 +77,24 @@ typedef struct String {
   int length;
   char* content;
   uint32_t hash;
+  bool interned;
 } String;
 
+typedef struct Rope {
+  Object object;
+  int length;
+  Object* left;
+  Object* right;
+  String* flat;
+} Rope;
+
+typedef struct Builder {
+  Object object;
+  int length;
+  int capacity;
+  char* content;
+} Builder;
+
 typedef struct Upvalue {
   Object object;
   Value* location;
@@ -106,14 +132,18 @@ typedef struct NativeMethod {
 typedef struct Class {
   Object object;
   String* identifier;
-  Table members;
+  Table layout;
+  Constants defaults;
   Table methods;
+  int version;
 } Class;
 
 typedef struct Instance {
   Object object;
   Class* class;
-  Table fields;
+  Table* dictionary;
+  int count;
+  Value fields[];
 } Instance;
 
 typedef struct Bound {
@@ -132,10 +162,23 @@ Number* allocate_number_from_gmp(VM* vm, mpf_t value);
 Number* allocate_number_from_double(VM* vm, double value);
 Number* allocate_number_from_string(VM* vm, const char* value);
 
-String* allocate_string(VM* vm, const char* content, int length, uint32_t hash);
+String* allocate_string(VM* vm, const char* content, int length);
 
 String* copy_string(VM* vm, const char* content, int length);
 String* take_string(VM* vm, const char* content, int length);
+String* loose_string(VM* vm, const char* content, int length);
+
+String* intern_string(VM* vm, String* string);
+
+String* concatenate(VM* vm, String* left, String* right);
+
+Object* join(VM* vm, Object* left, Object* right);
+
+String* flatten(VM* vm, Rope* rope);
+
+Builder* new_builder(VM* vm);
+
+void append_builder(VM* vm, Builder* builder, const char* content, int length);
 
 Upvalue* new_upvalue(VM* vm, Value* location);
 
@@ -151,6 +194,12 @@ Class* new_class(VM* vm, String* identifier);
 
 Instance* new_instance(VM* vm, Class* class);
 
+void define_member(VM* vm, Class* class, String* identifier, Value value);
+void define_method(VM* vm, Class* class, String* identifier, Value value);
+
+bool instance_get(Instance* instance, String* identifier, Value* value);
+bool instance_set(VM* vm, Instance* instance, String* identifier, Value value);
+
 Bound* new_bound(VM* vm, Value receiver, Closure* method);
 
 NativeBound* new_native_bound(VM* vm, Value receiver, NativeMethod* method);
@@ -161,4 +210,12 @@ static inline bool validate(Value value, Objects type) {
   return IS_OBJECT(value) && AS_OBJECT(value)->type == type;
 }
 
+static inline bool textual(Value value) {
+  return IS_OBJECT(value) && (AS_OBJECT(value)->type == OBJECT_STRING || AS_OBJECT(value)->type == OBJECT_ROPE);
+}
+
+static inline bool numeric(Value value) {
+  return IS_INTEGER(value) || IS_DOUBLE(value) || validate(value, OBJECT_NUMBER);
+}
+
 #endif
\ No newline at end of file
@@ -5,19 +5,41 @@
 
 #include "types/value.h"
 
-#define STACK_DEFAULT_SIZE 64 * 1024
+#define STACK_INITIAL_SIZE 1024
 
-typedef struct Stack {
-  Value content[STACK_DEFAULT_SIZE]; 
+#define STACK_DEFAULT_LIMIT 1024 * 1024
+
+// Every call leaves its frame room for 256 locals and as many temporaries.
+#define STACK_HEADROOM 2 * (UINT8_MAX + 1)
+
+// The interpreter grows the stack before its temporaries reach the last
+// STACK_RESERVE slots, which are left to the values that C code pushes.
+#define STACK_RESERVE 32
 
+typedef struct Stack {
+  Value* content;
   Value* top;
+  Value* end;
+
+  size_t capacity, limit;
 } Stack;
 
+// Only C code calls push(), to root a few values at a time, so it never
+// checks the bounds: the interpreter keeps STACK_RESERVE slots free for it.
+static inline void push(Stack* stack, Value value) {
+  *stack->top = value;
+
+  stack->top++;
+}
 
-void push(Stack* stack, Value value);
+static inline Value pop(Stack* stack, int count) {
+  stack->top = stack->top - count;
 
-Value pop(Stack* stack, int count);
+  return *stack->top;
+}
 
-Value peek(Stack* stack, int distance);
+static inline Value peek(Stack* stack, int distance) {
+  return stack->top[- 1 - distance];
+}
 
 #endif
\ No newline at end of file
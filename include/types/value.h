@@ -1,11 +1,15 @@
 #ifndef VALUE_H
 #define VALUE_H
 
+#include <string.h>
+
 #include "common.h"
 
 typedef struct Object Object;
 typedef struct Number Number;
 typedef struct String String;
+typedef struct Rope Rope;
+typedef struct Builder Builder;
 typedef struct Upvalue Upvalue;
 typedef struct Function Function;
 typedef struct Closure Closure;
@@ -16,21 +20,92 @@ typedef struct Instance Instance;
 typedef struct Bound Bound;
 typedef struct NativeBound NativeBound;
 
+#ifdef NAN_BOXING
+
+#define SIGN_BIT ( (uint64_t)0x8000000000000000 )
+#define QNAN ( (uint64_t)0x7ffc000000000000 )
+
+#define INTEGER_TAG ( (uint64_t)0x0001000000000000 )
+#define INTEGER_MASK ( (uint64_t)0x0000ffffffffffff )
+
+#define TAG_VOID 1
+#define TAG_FALSE 2
+#define TAG_TRUE 3
+#define TAG_UNDEFINED 4
+
+// Integers take all 48 bits below the tag, so they stay immediate well past
+// the range of int32_t.
+#define INTEGER_MIN ( -((int64_t)1 << 47) )
+#define INTEGER_MAX ( ((int64_t)1 << 47) - 1 )
+
+#define FITS_INTEGER(value) ( (value) >= INTEGER_MIN && (value) <= INTEGER_MAX )
+
+#define FALSE_VALUE ( (Value)(QNAN | TAG_FALSE) )
+#define TRUE_VALUE ( (Value)(QNAN | TAG_TRUE) )
+
+#define BOOLEAN(value) ( (value) ? TRUE_VALUE : FALSE_VALUE )
+#define INTEGER(value) ( (Value)(QNAN | INTEGER_TAG | ((uint64_t)(int64_t)(value) & INTEGER_MASK)) )
+#define DOUBLE(value) double_to_value(value)
+#define OBJECT(value) ( (Value)(SIGN_BIT | QNAN | (uint64_t)(uintptr_t)(value)) )
+#define VOID ( (Value)(QNAN | TAG_VOID) )
+#define UNDEFINED ( (Value)(QNAN | TAG_UNDEFINED) )
+
+#define IS_BOOLEAN(value) ( ((value) | 1) == TRUE_VALUE )
+#define IS_INTEGER(value) ( ((value) & (SIGN_BIT | QNAN | INTEGER_TAG)) == (QNAN | INTEGER_TAG) )
+#define IS_DOUBLE(value) ( ((value) & QNAN) != QNAN )
+#define IS_OBJECT(value) ( ((value) & (SIGN_BIT | QNAN)) == (SIGN_BIT | QNAN) )
+#define IS_VOID(value) ( (value) == VOID )
+#define IS_UNDEFINED(value) ( (value) == UNDEFINED )
+
+#define AS_BOOLEAN(value) ( (value) == TRUE_VALUE )
+#define AS_INTEGER(value) ( (int64_t)((value) << 16) >> 16 )
+#define AS_DOUBLE(value) value_to_double(value)
+#define AS_OBJECT(value) ( (Object*)(uintptr_t)((value) & ~(SIGN_BIT | QNAN)) )
+
+typedef uint64_t Value;
+
+static inline Value double_to_value(double number) {
+  Value value;
+  memcpy(&value, &number, sizeof(double));
+  return value;
+}
+
+static inline double value_to_double(Value value) {
+  double number;
+  memcpy(&number, &value, sizeof(Value));
+  return number;
+}
+
+#else
+
+#define INTEGER_MIN INT64_MIN
+#define INTEGER_MAX INT64_MAX
+
+#define FITS_INTEGER(value) ( (value) >= INTEGER_MIN && (value) <= INTEGER_MAX )
+
 #define BOOLEAN(value) ( (Value){ VALUE_BOOLEAN, { .boolean = value } } )
+#define INTEGER(value) ( (Value){ VALUE_INTEGER, { .integer = value } } )
+#define DOUBLE(value) ( (Value){ VALUE_DOUBLE, { .floating = value } } )
 #define OBJECT(value) ( (Value){ VALUE_OBJECT, { .object = (Object*)value } } )
 #define VOID ( (Value){ VALUE_VOID } )
 #define UNDEFINED ( (Value){ VALUE_UNDEFINED } )
 
 #define IS_BOOLEAN(value) ( (value).type == VALUE_BOOLEAN )
+#define IS_INTEGER(value) ( (value).type == VALUE_INTEGER )
+#define IS_DOUBLE(value) ( (value).type == VALUE_DOUBLE )
 #define IS_OBJECT(value) ( (value).type == VALUE_OBJECT )
 #define IS_VOID(value) ( (value).type == VALUE_VOID )
 #define IS_UNDEFINED(value) ( (value).type == VALUE_UNDEFINED )
 
 #define AS_BOOLEAN(value) ( (value).content.boolean )
+#define AS_INTEGER(value) ( (value).content.integer )
+#define AS_DOUBLE(value) ( (value).content.floating )
 #define AS_OBJECT(value) ( (value).content.object )
 
 typedef enum {
   VALUE_BOOLEAN,
+  VALUE_INTEGER,
+  VALUE_DOUBLE,
   VALUE_OBJECT,
   VALUE_VOID,
   VALUE_UNDEFINED
@@ -41,10 +116,14 @@ typedef struct {
 
   union {
     bool boolean;
+    int64_t integer;
+    double floating;
     Object* object;
   } content;
 } Value;
 
+#endif
+
 typedef struct {
   int capacity;
   int count;
@@ -58,6 +137,9 @@ void free_constants(Constants* constants);
 void write_constants(Constants* constants, Value value);
 
 bool equal(Value left, Value right);
+bool identical(Value left, Value right);
+
+uint32_t hash_value(Value value);
 
 void print_value(Value value);
 
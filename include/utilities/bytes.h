@@ -0,0 +1,24 @@
+#ifndef BYTES_H
+#define BYTES_H
+
+#include "common.h"
+
+#define HASH_STRIPE 64
+#define HASH_SECRET 24
+
+#define HASH_SHORT 16
+#define HASH_MEDIUM 128
+
+typedef struct {
+  const char* name;
+
+  uint32_t (*hash)(const char* string, int length);
+} Kernel;
+
+const Kernel* kernels(int* count);
+
+const Kernel* kernel();
+
+uint32_t hashing(const char* string, int length);
+
+#endif
\ No newline at end of file
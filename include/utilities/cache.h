@@ -0,0 +1,52 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "common.h"
+
+#include "vm.h"
+#include "types/object.h"
+
+#define CACHE_MAGIC "ELC"
+#define CACHE_VERSION 3
+
+#define CACHE_EXTENSION ".elc"
+#define SOURCE_EXTENSION ".eli"
+
+typedef enum {
+  CONSTANT_INTEGER,
+  CONSTANT_DOUBLE,
+  CONSTANT_NUMBER,
+  CONSTANT_LITERAL,
+  CONSTANT_STRING,
+  CONSTANT_FUNCTION,
+  CONSTANT_BOOLEAN,
+  CONSTANT_VOID,
+  CONSTANT_UNDEFINED
+} Kinds;
+
+typedef struct {
+  char magic[4];
+  uint32_t version;
+
+  uint32_t operations, value, limb;
+
+  uint32_t tier, numerics;
+  uint64_t precision;
+
+  int64_t seconds, nanoseconds;
+  uint64_t size;
+  uint32_t hash;
+
+  uint32_t globals;
+} Header;
+
+char* cache_path(const char* path);
+char* source_path(const char* path);
+
+bool write_cache(VM* vm, Function* function, const char* path, const char* source, size_t length);
+
+Function* load_cache(VM* vm, const char* path);
+
+void free_mappings(VM* vm);
+
+#endif
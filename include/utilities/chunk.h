@@ -6,7 +6,7 @@
 #include "types/value.h"
 
 #define FOREACH(OPERATION) \
-  OPERATION(OP_CONSTANT) \
+  OPERATION(OP_CONSTANT) OPERATION(OP_CONSTANT_LONG) \
   OPERATION(OP_TRUE) OPERATION(OP_FALSE) \
   OPERATION(OP_VOID) OPERATION(OP_UNDEFINED) \
   OPERATION(OP_NEGATION) \
@@ -30,7 +30,19 @@
   OPERATION(OP_MEMBER) OPERATION(OP_METHOD) \
   OPERATION(OP_PROPERTY_SET) OPERATION(OP_PROPERTY_GET) \
   OPERATION(OP_INVOKE) \
-  OPERATION(OP_INHERIT) OPERATION(OP_SUPER) \
+  OPERATION(OP_INHERIT) OPERATION(OP_SUPER) OPERATION(OP_SUPER_INVOKE) \
+  OPERATION(OP_REGISTER_ADD) OPERATION(OP_REGISTER_ADD_CONSTANT) \
+  OPERATION(OP_REGISTER_SUBTRACT) OPERATION(OP_REGISTER_SUBTRACT_CONSTANT) \
+  OPERATION(OP_REGISTER_MULTIPLY) OPERATION(OP_REGISTER_MULTIPLY_CONSTANT) \
+  OPERATION(OP_REGISTER_DIVIDE) OPERATION(OP_REGISTER_DIVIDE_CONSTANT) \
+  OPERATION(OP_REGISTER_EQUAL) OPERATION(OP_REGISTER_EQUAL_CONSTANT) \
+  OPERATION(OP_REGISTER_GREATER) OPERATION(OP_REGISTER_GREATER_CONSTANT) \
+  OPERATION(OP_REGISTER_LESS) OPERATION(OP_REGISTER_LESS_CONSTANT) \
+  OPERATION(OP_REGISTER_STORE) OPERATION(OP_REGISTER_MOVE) \
+  OPERATION(OP_INCREMENT_LOCAL) OPERATION(OP_DECREMENT_LOCAL) \
+  OPERATION(OP_NOT_EQUAL) OPERATION(OP_GREATER_EQUAL) OPERATION(OP_LESS_EQUAL) \
+  OPERATION(OP_LESS_JUMP) \
+  OPERATION(OP_LOCAL_GET_PROPERTY) \
   OPERATION(OP_EMPTY) \
   OPERATION(OP_EXIT) 
 
@@ -42,6 +54,43 @@ typedef enum {
   FOREACH(ENUMERATE)
 } Operations;
 
+#define CACHE_ENTRIES 4
+
+typedef enum {
+  RESOLUTION_FIELD,
+  RESOLUTION_METHOD,
+  RESOLUTION_NATIVE
+} Resolutions;
+
+typedef struct {
+  void* shape;
+  int version;
+
+  Resolutions resolution;
+
+  int slot;
+  Value value;
+} Resolution;
+
+typedef struct {
+  int count;
+  bool megamorphic;
+
+  Resolution entries[CACHE_ENTRIES];
+} Cache;
+
+typedef struct {
+  int count;
+  int capacity;
+  Cache* content;
+} Caches;
+
+typedef struct {
+  int count;
+  int capacity;
+  int* content;
+} Indexes;
+
 typedef struct {
   int count;
   int capacity;
@@ -50,6 +99,9 @@ typedef struct {
   int* lines;
 
   Constants constants;
+  Indexes indexes;
+
+  Caches caches;
 } Chunk;
 
 void initialize_chunk(Chunk* chunk, VM* vm);
@@ -57,5 +109,7 @@ void free_chunk(Chunk* chunk);
 void write_chunk(Chunk* chunk, uint8_t byte, int line);
 
 int add_constant(Chunk* chunk, Value value);
+int intern_constant(Chunk* chunk, Value value);
+int add_cache(Chunk* chunk);
 
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "common.h"
 
+#include "vm.h"
 #include "types/object.h"
 
 #define MINIMUM_CAPACITY 8
@@ -11,6 +12,12 @@
 
 #define GARBAGE_COLLECTOR_GROW_FACTOR 2
 
+#define NURSERY_SIZE ( 1024 * 256 )
+
+#define SLICE_SIZE ( 1024 * 16 )
+
+#define SLICE_BUDGET 1024
+
 #define GROW_CAPACITY(capacity) \
   ( (capacity) < MINIMUM_CAPACITY ? MINIMUM_CAPACITY : (capacity) * LOAD_FACTOR )
 
@@ -26,22 +33,39 @@
 #define FREE_ARRAY(vm, type, pointer, capacity) \
   reallocate( vm, (pointer), sizeof(type) * (capacity), 0 )
 
-typedef struct {
-  int count;
-  int capacity;
-  Object** content;
-} Parents;
-
 void* reallocate(VM* vm, void* pointer, size_t oldest, size_t newest);
 
 void recycle(VM* vm);
+void recycle_nursery(VM* vm);
+void recycle_slice(VM* vm);
 
 void roots(VM* vm, Parents* parents);
 void traverse(VM* vm, Parents* parents);
 
 void mark(Parents* parents, Value value);
+void gray(Parents* parents, Object* object);
 
 void sweep(VM* vm);
+void sweep_nursery(VM* vm);
+
+void remember(VM* vm, Object* object);
+
+double percentile(Statistics* statistics, double fraction);
+
+static inline void barrier(VM* vm, Object* owner, Value value) {
+  if (IS_OBJECT(value) == false || AS_OBJECT(value) == NULL) return;
+
+  if (vm->phase == PHASE_MARK) {
+    if (owner->mark == true)
+      mark(&vm->gray, value);
+
+    return;
+  }
+
+  if (AS_OBJECT(value)->old == false)
+    if (owner->old == true && owner->remembered == false)
+      remember(vm, owner);
+}
 
 void free_object(VM* vm, Object* object);
 
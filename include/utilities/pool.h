@@ -0,0 +1,39 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "common.h"
+
+#define POOL_GRANULARITY 16
+
+#define POOL_CLASSES 16
+
+#define POOL_MAXIMUM_SIZE ( POOL_GRANULARITY * POOL_CLASSES )
+
+#define POOL_SLAB_SIZE ( 64 * 1024 )
+
+#define POOL_CLASS(size) ( ((size) - 1) / POOL_GRANULARITY )
+
+typedef struct Block {
+  struct Block* next;
+} Block;
+
+typedef struct Slab {
+  struct Slab* next;
+} Slab;
+
+typedef struct {
+  Block* blocks[POOL_CLASSES];
+
+  Slab* slabs;
+
+  char* cursor;
+  char* end;
+} Pool;
+
+void initialize_pool(Pool* pool);
+void free_pool(Pool* pool);
+
+void* pool_allocate(Pool* pool, size_t size);
+void pool_release(Pool* pool, void* pointer, size_t size);
+
+#endif
@@ -7,15 +7,7 @@
 
 #define MAX_LOAD 0.75
 
-#if (defined(__GNUC__) && defined(__i386__)) || defined(__WATCOMC__) \
-  || defined(_MSC_VER) || defined (__BORLANDC__) || defined (__TURBOC__)
-    #define BITS(d) (*((const uint16_t *) (d)))
-#endif
-
-#if !defined (BITS)
-    #define BITS(d) ((((uint32_t)(((const uint8_t *)(d))[1])) << 8) \
-                       +(uint32_t)(((const uint8_t *)(d))[0]) )
-#endif
+#define PROBE_BUCKETS 16
 
 typedef struct {
   String* key;
@@ -27,9 +19,20 @@ typedef struct {
   int capacity;
   Entry* entries;
 
+  Object* owner;
+  bool young;
+
   VM* vm;
 } Table;
 
+typedef struct {
+  int entries, longest;
+
+  size_t total;
+
+  int histogram[PROBE_BUCKETS];
+} Probes;
+
 void initialize_table(Table* table, VM* vm);
 void free_table(Table* table);
 
@@ -38,12 +41,10 @@ bool table_get(Table* table, String* key, Value* value);
 
 bool table_delete(Table* table, String* key);
 
-void table_clear(Table* table);
-
 void table_append(Table* from, Table* to);
 
 String* table_find_string(Table* table, const char* content, int length, uint32_t hash);
 
-uint32_t hashing(const char* string, int length);
+void table_probes(Table* table, Probes* probes);
 
 #endif
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include "utilities/chunk.h"
 #include "utilities/table.h"
+#include "utilities/pool.h"
 #include "types/stack.h"
 #include "types/value.h"
 #include "natives/methods.h"
@@ -29,26 +30,146 @@ typedef struct {
   int count;
 } Call;
 
+typedef enum {
+  NUMERICS_PRECISE,
+  NUMERICS_FAST
+} Numerics;
+
+typedef struct {
+  int count;
+  int capacity;
+  Object** content;
+
+  bool young;
+} Parents;
+
+#define VACANT OBJECT(NULL)
+
+#define IS_VACANT(value) ( IS_OBJECT(value) && AS_OBJECT(value) == NULL )
+
+typedef struct {
+  int count;
+  int capacity;
+  Value* values;
+  String** identifiers;
+
+  Table slots;
+} Globals;
+
+typedef struct {
+  void* address;
+  size_t size;
+} Mapping;
+
+typedef struct {
+  int count;
+  int capacity;
+  Mapping* content;
+} Mappings;
+
+#define PAUSE_BUCKETS 96
+
+typedef struct {
+  int minors, majors, slices;
+
+  size_t promoted, freed;
+
+  double pause, longest, total;
+
+  int pauses[PAUSE_BUCKETS];
+} Statistics;
+
+typedef struct {
+  size_t hits, misses, megamorphic;
+
+  size_t instructions;
+} Counters;
+
+typedef enum {
+  COLLECTOR_GENERATIONAL,
+  COLLECTOR_INCREMENTAL
+} Collectors;
+
+typedef enum {
+  TIER_STACK,
+  TIER_REGISTER
+} Tiers;
+
+typedef enum {
+  PHASE_IDLE,
+  PHASE_MARK,
+  PHASE_SWEEP
+} Phases;
+
+typedef struct {
+  mp_bitcnt_t precision;
+  Numerics numerics;
+  Collectors collector;
+  Tiers tier;
+
+  size_t stack, limit;
+
+  bool disassemble;
+} Settings;
+
 typedef struct VM {
-  size_t allocate, threshold;
+  Settings settings;
+
+  size_t allocate, threshold, young;
+
+  Pool pool;
+
+  Parents remembered;
+
+  Phases phase;
+
+  Parents gray;
+
+  Parents scripts;
+
+  Mappings mappings;
+
+  Object* sweeping;
+  Object* survivors;
+  Object* last;
+
+  Statistics statistics;
+
+  Counters counters;
 
   Call call;
 
   Stack stack;
 
-  Table strings, globals;
+  Table strings, numbers;
+
+  Globals globals;
 
   Prototypes prototypes;
 
   Upvalue* upvalues;
 
   Object* objects;
+  Object* old;
+
+  struct Parser* parser;
 } VM;
 
-void initialize_VM(VM* vm);
+void set_settings(Settings* settings);
+
+void initialize_VM(VM* vm, Settings* settings);
 void free_VM(VM* vm);
 void reset_VM(VM* vm);
 
+Results execute(VM* vm, Function* function);
 Results interpret(VM* vm, const char* source);
 
+int global_slot(VM* vm, String* identifier);
+
+static inline bool falsey(Value value) {
+  return IS_VOID(value) || 
+         IS_UNDEFINED(value) || 
+         (IS_BOOLEAN(value) && AS_BOOLEAN(value) == false);
+}
+
 #endif
\ No newline at end of file
@@ -5,8 +5,11 @@
 
 #include "vm.h"
 #include "compiler.h"
+#include "optimizer.h"
+#include "helpers/disassebler.h"
 #include "tokenizer.h"
 #include "types/object.h"
+#include "types/number.h"
 
 #define GET_CURRENT_CHUNK(compiler) \
   ( &compiler->function->chunk )
@@ -41,6 +44,11 @@ static void set_compiler(Parser* parser, Compiler* compiler, Positions position)
   compiler->count = 0;
   compiler->scope = 0;
 
+  compiler->operand = INITIALIZE;
+  compiler->literal = INITIALIZE;
+  compiler->store = INITIALIZE;
+  compiler->label = 0;
+
   compiler->function = new_function(parser->vm);
 
   parser->compiler = compiler;
@@ -173,6 +181,12 @@ static Function* terminate(Parser* parser) {
 
   Function* function = parser->compiler->function;
 
+  if (parser->error == false)
+    optimize(&function->chunk);
+
+  if (parser->error == false && parser->vm->settings.disassemble == true)
+    disassemble_chunk(&function->chunk, function->identifier != NULL ? function->identifier->content : "Top-Level");
+
   parser->compiler = parser->compiler->enclosing;
 
   return function;
@@ -229,36 +243,302 @@ static Token synthetic(const char* text) {
   return token;
 }
 
-static uint8_t make(Parser* parser, Value value) {
-  int constant = add_constant(GET_CURRENT_CHUNK(parser->compiler), value);
+static uint16_t make(Parser* parser, Value value) {
+  int constant = intern_constant(GET_CURRENT_CHUNK(parser->compiler), value);
 
-  if (constant > UINT8_MAX) {
+  if (constant > UINT16_MAX) {
     error(parser, parser->previous, compile_time_errors[TOO_MANY_CONSTANTS]);
     return 0;
   }
 
-  return (uint8_t)constant;
+  return (uint16_t)constant;
+}
+
+static void emit_index(Parser* parser, uint16_t constant) {
+  EMIT_BYTE(parser, (constant >> 8) & 0xff);
+  EMIT_BYTE(parser, constant & 0xff);
+}
+
+static void cache(Parser* parser) {
+  int cache = add_cache(GET_CURRENT_CHUNK(parser->compiler));
+
+  if (cache > UINT16_MAX)
+    error(parser, parser->previous, compile_time_errors[TOO_MANY_CACHES]);
+
+  EMIT_BYTE(parser, (cache >> 8) & 0xff);
+  EMIT_BYTE(parser, cache & 0xff);
 }
 
 static void constant(Parser* parser, Value value) {
-  uint8_t constant = make(parser, value);
+  int constant = intern_constant(GET_CURRENT_CHUNK(parser->compiler), value);
+
+  parser->compiler->literal = GET_CURRENT_CHUNK(parser->compiler)->count;
+
+  if (constant > UINT16_MAX) {
+    error(parser, parser->previous, compile_time_errors[TOO_MANY_CONSTANTS]);
+    return;
+  }
+
+  if (constant > UINT8_MAX) {
+    EMIT_BYTE(parser, OP_CONSTANT_LONG);
+    EMIT_BYTE(parser, (constant >> 8) & 0xff);
+    EMIT_BYTE(parser, constant & 0xff);
+    return;
+  }
+
+  parser->compiler->operand = GET_CURRENT_CHUNK(parser->compiler)->count;
 
   EMIT_BYTE(parser, OP_CONSTANT);
   EMIT_BYTE(parser, constant);
 }
 
+static void retract(Parser* parser, int offset) {
+  Compiler* compiler = parser->compiler;
+
+  GET_CURRENT_CHUNK(compiler)->count = offset;
+
+  compiler->operand = INITIALIZE;
+  compiler->literal = INITIALIZE;
+  compiler->store = INITIALIZE;
+
+  if (compiler->label > offset)
+    compiler->label = offset;
+}
+
+static int foldable(Parser* parser) {
+  Compiler* compiler = parser->compiler;
+
+  Chunk* chunk = GET_CURRENT_CHUNK(compiler);
+
+  int offset = compiler->literal;
+
+  if (offset == INITIALIZE || offset < compiler->label || offset >= chunk->count)
+    return INITIALIZE;
+
+  switch (chunk->code[offset]) {
+    case OP_CONSTANT:
+      return offset + 2 == chunk->count ? offset : INITIALIZE;
+
+    case OP_CONSTANT_LONG:
+      return offset + 3 == chunk->count ? offset : INITIALIZE;
+
+    case OP_TRUE:
+    case OP_FALSE:
+    case OP_VOID:
+    case OP_UNDEFINED:
+      return offset + 1 == chunk->count ? offset : INITIALIZE;
+
+    default: return INITIALIZE;
+  }
+}
+
+static Value evaluate(Chunk* chunk, int offset) {
+  switch (chunk->code[offset]) {
+    case OP_CONSTANT: return chunk->constants.values[chunk->code[offset + 1]];
+
+    case OP_CONSTANT_LONG: return chunk->constants.values[(chunk->code[offset + 1] << 8) | chunk->code[offset + 2]];
+
+    case OP_TRUE: return BOOLEAN(true);
+    case OP_FALSE: return BOOLEAN(false);
+
+    case OP_VOID: return VOID;
+
+    default: return UNDEFINED;
+  }
+}
+
+static bool compute(VM* vm, uint8_t instruction, Value left, Value right, Value* result) {
+  Arithmetics operation;
+
+  switch (instruction) {
+    case OP_ADD:
+      if (IS_STRING(left) && IS_STRING(right)) {
+        *result = OBJECT(concatenate(vm, AS_STRING(left), AS_STRING(right)));
+        return true;
+      }
+
+      operation = ARITHMETIC_ADD;
+      break;
+
+    case OP_SUBTRACT: operation = ARITHMETIC_SUBTRACT; break;
+    case OP_MULTIPLY: operation = ARITHMETIC_MULTIPLY; break;
+    case OP_DIVIDE: operation = ARITHMETIC_DIVIDE; break;
+    case OP_POWER: operation = ARITHMETIC_POWER; break;
+
+    case OP_EQUAL:
+      *result = BOOLEAN(equal(left, right));
+      return true;
+
+    case OP_GREATER:
+    case OP_LESS: {
+      int order;
+
+      if (IS_INTEGER(left) && IS_INTEGER(right))
+        order = (AS_INTEGER(left) > AS_INTEGER(right)) - (AS_INTEGER(left) < AS_INTEGER(right));
+      else if (IS_STRING(left) && IS_STRING(right)) {
+        String* first = AS_STRING(left);
+        String* second = AS_STRING(right);
+
+        order = first->length - second->length;
+
+        if (first->length == second->length)
+          order = memcmp(first->content, second->content, first->length);
+      }
+      else return false;
+
+      *result = BOOLEAN(instruction == OP_GREATER ? order > 0 : order < 0);
+      return true;
+    }
+
+    default: return false;
+  }
+
+  if (IS_NUMBER(left) == false || IS_NUMBER(right) == false)
+    return false;
+
+  if (IS_NUMBER_OBJECT(left) || IS_NUMBER_OBJECT(right))
+    return false;
+
+  if (instruction == OP_DIVIDE && zero(right))
+    return false;
+
+  *result = arithmetic(vm, operation, left, right);
+
+  return IS_NUMBER_OBJECT(*result) == false;
+}
+
+static void emit_literal(Parser* parser, Value value) {
+  if (IS_BOOLEAN(value) == false) {
+    constant(parser, value);
+    return;
+  }
+
+  parser->compiler->literal = GET_CURRENT_CHUNK(parser->compiler)->count;
+
+  EMIT_BYTE(parser, AS_BOOLEAN(value) ? OP_TRUE : OP_FALSE);
+}
+
+static bool fold(Parser* parser, uint8_t instruction, int left) {
+  Compiler* compiler = parser->compiler;
+
+  Chunk* chunk = GET_CURRENT_CHUNK(compiler);
+
+  int right = foldable(parser);
+
+  if (left == INITIALIZE || right == INITIALIZE || compiler->label > left)
+    return false;
+
+  int width = chunk->code[left] == OP_CONSTANT_LONG ? 3 : chunk->code[left] == OP_CONSTANT ? 2 : 1;
+
+  if (right != left + width)
+    return false;
+
+  Value result;
+
+  if (compute(parser->vm, instruction, evaluate(chunk, left), evaluate(chunk, right), &result) == false)
+    return false;
+
+  retract(parser, left);
+
+  emit_literal(parser, result);
+
+  return true;
+}
+
+static int operand(Parser* parser) {
+  Compiler* compiler = parser->compiler;
+
+  if (compiler->operand != GET_CURRENT_CHUNK(compiler)->count - 2)
+    return INITIALIZE;
+
+  return compiler->operand;
+}
+
+static int registers(uint8_t instruction, bool constant) {
+  switch (instruction) {
+    case OP_ADD: return constant ? OP_REGISTER_ADD_CONSTANT : OP_REGISTER_ADD;
+    case OP_SUBTRACT: return constant ? OP_REGISTER_SUBTRACT_CONSTANT : OP_REGISTER_SUBTRACT;
+    case OP_MULTIPLY: return constant ? OP_REGISTER_MULTIPLY_CONSTANT : OP_REGISTER_MULTIPLY;
+    case OP_DIVIDE: return constant ? OP_REGISTER_DIVIDE_CONSTANT : OP_REGISTER_DIVIDE;
+
+    case OP_EQUAL: return constant ? OP_REGISTER_EQUAL_CONSTANT : OP_REGISTER_EQUAL;
+    case OP_GREATER: return constant ? OP_REGISTER_GREATER_CONSTANT : OP_REGISTER_GREATER;
+    case OP_LESS: return constant ? OP_REGISTER_LESS_CONSTANT : OP_REGISTER_LESS;
+
+    default: return INITIALIZE;
+  }
+}
+
+static void emit_operation(Parser* parser, uint8_t instruction, int left) {
+  Compiler* compiler = parser->compiler;
+
+  Chunk* chunk = GET_CURRENT_CHUNK(compiler);
+
+  int right = operand(parser);
+
+  if (parser->vm->settings.tier == TIER_REGISTER && left != INITIALIZE && right == left + 2 && compiler->label <= left) {
+    int operation = registers(instruction, chunk->code[right] == OP_CONSTANT);
+
+    if (chunk->code[left] == OP_LOCAL_GET && operation != INITIALIZE) {
+      chunk->code[left] = (uint8_t)operation;
+      chunk->code[left + 2] = chunk->code[right + 1];
+      chunk->count = left + 3;
+
+      compiler->operand = INITIALIZE;
+      compiler->literal = INITIALIZE;
+
+      return;
+    }
+  }
+
+  EMIT_BYTE(parser, instruction);
+}
+
+static void discard(Parser* parser) {
+  Compiler* compiler = parser->compiler;
+
+  Chunk* chunk = GET_CURRENT_CHUNK(compiler);
+
+  int store = compiler->store;
+
+  if (parser->vm->settings.tier == TIER_REGISTER && store == chunk->count - 2 && compiler->label <= store) {
+    compiler->store = INITIALIZE;
+
+    if (compiler->operand == store - 2 && compiler->label <= store - 2 && chunk->code[store - 2] == OP_LOCAL_GET) {
+      uint8_t source = chunk->code[store - 1];
+
+      chunk->code[store - 2] = OP_REGISTER_MOVE;
+      chunk->code[store - 1] = chunk->code[store + 1];
+      chunk->code[store] = source;
+      chunk->count = store + 1;
+
+      compiler->operand = INITIALIZE;
+      compiler->literal = INITIALIZE;
+
+      return;
+    }
+
+    chunk->code[store] = OP_REGISTER_STORE;
+
+    return;
+  }
+
+  EMIT_BYTE(parser, OP_POP);
+}
+
 static bool identifiers_equality(Token* left, Token* right) {
   if (left->length != right->length) return false;
   return memcmp(left->start, right->start, left->length) == 0;
 }
 
-static uint8_t identify(Parser* parser, Token* token) {
+static uint16_t identify(Parser* parser, Token* token) {
   String* string = copy_string(parser->vm, token->start, token->length);
   Value value = OBJECT(string);
 
   return make(parser, value);
 }
 
+
 static void local(Parser* parser, Token identifier) {
   if (parser->compiler->count == MAXIMUM_LIMIT) {
     error(parser, parser->previous, compile_time_errors[TOO_MANY_LOCALS]);
@@ -271,6 +551,17 @@ static void local(Parser* parser, Token identifier) {
   local->captured = false;
 }
 
+static int resolve_global(Parser* parser, Token* identifier) {
+  String* string = copy_string(parser->vm, identifier->start, identifier->length);
+
+  int slot = global_slot(parser->vm, string);
+
+  if (slot > UINT16_MAX)
+    error(parser, parser->previous, compile_time_errors[TOO_MANY_GLOBALS]);
+
+  return slot;
+}
+
 static int resolve_local(Parser* parser, Compiler* compiler, Token* identifier) {
   for (int i = compiler->count - 1; i >= 0; i--) {
     Local* local = &compiler->locals[i];
@@ -332,10 +623,11 @@ static void mark(Parser* parser, bool force) {
   parser->compiler->locals[parser->compiler->count - 1].depth = parser->compiler->scope;
 }
 
-static void initialize(Parser* parser, uint8_t global, bool force) {
+static void initialize(Parser* parser, int global, bool force) {
   if (parser->compiler->scope == 0 || force == true) {
     EMIT_BYTE(parser, OP_GLOBAL_INITIALIZE);
-    EMIT_BYTE(parser, global);
+    EMIT_BYTE(parser, (global >> 8) & 0xff);
+    EMIT_BYTE(parser, global & 0xff);
   }
   else mark(parser, force);
 }
@@ -357,13 +649,13 @@ static void declaration(Parser* parser, bool force) {
   local(parser, *identifier);
 }
 
-static uint8_t definition(Parser* parser, const char* error, bool force) {
+static int definition(Parser* parser, const char* error, bool force) {
   consume(parser, TOKEN_IDENTIFIER, error);
 
   declaration(parser, force);
 
   if (parser->compiler->scope == 0 || force == true) 
-    return identify(parser, &parser->previous);
+    return resolve_global(parser, &parser->previous);
   else return 0;
 }
 
@@ -411,6 +703,25 @@ static uint8_t arguments(Parser* parser) {
   return count;
 }
 
+static void emit_variable(Parser* parser, uint8_t instruction, int argument) {
+  Compiler* compiler = parser->compiler;
+
+  int offset = GET_CURRENT_CHUNK(compiler)->count;
+
+  EMIT_BYTE(parser, instruction);
+
+  if (instruction == OP_GLOBAL_SET || instruction == OP_GLOBAL_GET)
+    EMIT_BYTE(parser, (argument >> 8) & 0xff);
+
+  EMIT_BYTE(parser, argument & 0xff);
+
+  if (instruction == OP_LOCAL_GET)
+    compiler->operand = offset;
+
+  if (instruction == OP_LOCAL_SET)
+    compiler->store = offset;
+}
+
 static void emit_assignment(Parser* parser, Token identifier, bool assign) {
   uint8_t setter = 0, getter = 0;
 
@@ -426,7 +737,7 @@ static void emit_assignment(Parser* parser, Token identifier, bool assign) {
       setter = OP_UP_SET;
       getter = OP_UP_GET;
     } else {
-      argument = identify(parser, &identifier);
+      argument = resolve_global(parser, &identifier);
 
       setter = OP_GLOBAL_SET;
       getter = OP_GLOBAL_GET;
@@ -435,29 +746,29 @@ static void emit_assignment(Parser* parser, Token identifier, bool assign) {
 
   if (assign && match(parser, TOKEN_ASSIGN)) {
     expression(parser);
-    EMIT_BYTE(parser, setter);
+    emit_variable(parser, setter, argument);
   }
   else if (assign && match(parser, TOKEN_INCREMENT)) {
-    EMIT_BYTE(parser, getter);
-    EMIT_BYTE(parser, argument);
+    emit_variable(parser, getter, argument);
 
-    constant(parser, OBJECT(allocate_number_from_double(parser->vm, 1.0)));
+    int left = operand(parser);
 
-    EMIT_BYTE(parser, OP_ADD);
-    EMIT_BYTE(parser, setter);
+    constant(parser, INTEGER(1));
+
+    emit_operation(parser, OP_ADD, left);
+    emit_variable(parser, setter, argument);
   }
   else if (assign && match(parser, TOKEN_DECREMENT)) {
-    EMIT_BYTE(parser, getter);
-    EMIT_BYTE(parser, argument);
+    emit_variable(parser, getter, argument);
 
-    constant(parser, OBJECT(allocate_number_from_double(parser->vm, 1.0)));
+    int left = operand(parser);
 
-    EMIT_BYTE(parser, OP_SUBTRACT);
-    EMIT_BYTE(parser, setter);
-  }
-  else EMIT_BYTE(parser, getter);
+    constant(parser, INTEGER(1));
 
-  EMIT_BYTE(parser, argument);
+    emit_operation(parser, OP_SUBTRACT, left);
+    emit_variable(parser, setter, argument);
+  }
+  else emit_variable(parser, getter, argument);
 }
 
 static void emit_function(Parser* parser, Positions position, bool assign) {
@@ -477,7 +788,7 @@ static void emit_function(Parser* parser, Positions position, bool assign) {
         if (parser->compiler->function->arity > 255)
           error(parser, parser->current, compile_time_errors[MAXIMUM_PARAMETERS]);
 
-        uint8_t parameter = definition(parser, compile_time_errors[EXPECT_PARAMETER_IDENTIFIER], false);
+        int parameter = definition(parser, compile_time_errors[EXPECT_PARAMETER_IDENTIFIER], false);
         
         initialize(parser, parameter, false);
       } while (match(parser, TOKEN_COMMA) == true);
@@ -499,7 +810,9 @@ static void emit_function(Parser* parser, Positions position, bool assign) {
   if (assign == true)
     function->identifier = NULL;
 
-  stream(parser, 2, OP_CLOSURE, make(parser, OBJECT(function)));
+  uint16_t constant = make(parser, OBJECT(function));
+
+  stream(parser, 3, OP_CLOSURE, (constant >> 8) & 0xff, constant & 0xff);
 
   for (int i = 0; i < function->count; i++) {
     EMIT_BYTE(parser, compiler.ups[i].local ? 1 : 0);
@@ -515,6 +828,8 @@ static void patch(Parser* parser, int offset) {
 
   GET_CURRENT_CHUNK(parser->compiler)->code[offset] = (jump >> 8) & 0xff;
   GET_CURRENT_CHUNK(parser->compiler)->code[offset + 1] = jump & 0xff;
+
+  parser->compiler->label = GET_CURRENT_CHUNK(parser->compiler)->count;
 }
 
 static int jump(Parser* parser, uint8_t instruction) {
@@ -544,15 +859,55 @@ static void grouping(Parser* parser, bool assign) {
   consume(parser, TOKEN_CLOSE_PARENTHESES, "Expect a close parentheses after expression.");
 }
 
+static void emit_unary(Parser* parser, uint8_t instruction, int start) {
+  Chunk* chunk = GET_CURRENT_CHUNK(parser->compiler);
+
+  if (foldable(parser) == start) {
+    Value value = evaluate(chunk, start);
+
+    if (instruction == OP_NOT) {
+      retract(parser, start);
+      emit_literal(parser, BOOLEAN(falsey(value)));
+      return;
+    }
+
+    if (IS_NUMBER(value) && IS_NUMBER_OBJECT(value) == false) {
+      Value result = negation(parser->vm, value);
+
+      if (IS_NUMBER_OBJECT(result) == false) {
+        retract(parser, start);
+        emit_literal(parser, result);
+        return;
+      }
+    }
+  }
+
+  EMIT_BYTE(parser, instruction);
+}
+
+static void emit_binary(Parser* parser, uint8_t instruction, int left, int folding) {
+  if (fold(parser, instruction, folding) == true)
+    return;
+
+  if (instruction == OP_POWER) {
+    EMIT_BYTE(parser, OP_POWER);
+    return;
+  }
+
+  emit_operation(parser, instruction, left);
+}
+
 static void unary(Parser* parser, bool assign) {
   Types operator = parser->previous.type;
 
+  int start = GET_CURRENT_CHUNK(parser->compiler)->count;
+
   parse(parser, PRECEDENCE_UNARY);
 
   switch (operator) {
-    case TOKEN_MINUS: EMIT_BYTE(parser, OP_NEGATION); break;
+    case TOKEN_MINUS: emit_unary(parser, OP_NEGATION, start); break;
 
-    case TOKEN_NOT: EMIT_BYTE(parser, OP_NOT); break;
+    case TOKEN_NOT: emit_unary(parser, OP_NOT, start); break;
 
     default: return;
   }
@@ -565,38 +920,35 @@ static void binary(Parser* parser, bool assign) {
 
   Precedences precedence = (Precedences)(rule->precedence + 1);
 
+  int left = operand(parser);
+  int folding = foldable(parser);
+
   parse(parser, precedence);
 
+  int start = folding != INITIALIZE ? folding : GET_CURRENT_CHUNK(parser->compiler)->count;
+
   switch (operator) {
-    case TOKEN_PLUS: EMIT_BYTE(parser, OP_ADD); break;
-    case TOKEN_MINUS: EMIT_BYTE(parser, OP_SUBTRACT); break;
-    case TOKEN_ASTERISK: EMIT_BYTE(parser, OP_MULTIPLY); break;
-    case TOKEN_SLASH: EMIT_BYTE(parser, OP_DIVIDE); break;
+    case TOKEN_PLUS: emit_binary(parser, OP_ADD, left, folding); break;
+    case TOKEN_MINUS: emit_binary(parser, OP_SUBTRACT, left, folding); break;
+    case TOKEN_ASTERISK: emit_binary(parser, OP_MULTIPLY, left, folding); break;
+    case TOKEN_SLASH: emit_binary(parser, OP_DIVIDE, left, folding); break;
 
-    case TOKEN_CARET: EMIT_BYTE(parser, OP_POWER); break;
+    case TOKEN_CARET: emit_binary(parser, OP_POWER, left, folding); break;
 
-    case TOKEN_EQUAL: EMIT_BYTE(parser, OP_EQUAL); break;
-    case TOKEN_NOT_EQUAL: stream(parser, 2, OP_EQUAL, OP_NOT); break;
+    case TOKEN_EQUAL: emit_binary(parser, OP_EQUAL, left, folding); break;
+    case TOKEN_NOT_EQUAL: emit_binary(parser, OP_EQUAL, left, folding); emit_unary(parser, OP_NOT, start); break;
 
-    case TOKEN_GREATER: EMIT_BYTE(parser, OP_GREATER); break;
-    case TOKEN_GREATER_EQUAL: stream(parser, 2, OP_LESS, OP_NOT); break;
-    case TOKEN_LESS: EMIT_BYTE(parser, OP_LESS); break;
-    case TOKEN_LESS_EQUAL: stream(parser, 2, OP_GREATER, OP_NOT); break;
+    case TOKEN_GREATER: emit_binary(parser, OP_GREATER, left, folding); break;
+    case TOKEN_GREATER_EQUAL: emit_binary(parser, OP_LESS, left, folding); emit_unary(parser, OP_NOT, start); break;
+    case TOKEN_LESS: emit_binary(parser, OP_LESS, left, folding); break;
+    case TOKEN_LESS_EQUAL: emit_binary(parser, OP_GREATER, left, folding); emit_unary(parser, OP_NOT, start); break;
 
     default: return;
   }
 }
 
 static void number(Parser* parser, bool assign) {
-  char string[parser->previous.length + 1];
-
-  strncpy(string, parser->previous.start, parser->previous.length + 1);
-
-  string[parser->previous.length] = '\0';
-
-  Number* number = allocate_number_from_string(parser->vm, string);
-
-  Value value = OBJECT(number);
+  Value value = intern_number(parser->vm, parser->previous.start, parser->previous.length);
 
   constant(parser, value);
 }
@@ -610,6 +962,8 @@ static void string(Parser* parser, bool assign) {
 }
 
 static void literal(Parser* parser, bool assign) {
+  parser->compiler->literal = GET_CURRENT_CHUNK(parser->compiler)->count;
+
   switch (parser->previous.type) {
     case TOKEN_TRUE: EMIT_BYTE(parser, OP_TRUE); break;
     case TOKEN_FALSE: EMIT_BYTE(parser, OP_FALSE); break;
@@ -684,24 +1038,27 @@ static void call(Parser* parser, bool assign) {
 static void accessor(Parser* parser, bool assign) {
   consume(parser, TOKEN_IDENTIFIER, compile_time_errors[EXPECT_PROPERTY_IDENTIFIER]);
 
-  uint8_t property = identify(parser, &parser->previous);
+  uint16_t property = identify(parser, &parser->previous);
 
   if (assign && match(parser, TOKEN_ASSIGN)) {
     expression(parser);
     EMIT_BYTE(parser, OP_PROPERTY_SET);
-    EMIT_BYTE(parser, property);
+    emit_index(parser, property);
+    cache(parser);
   }
   else if (match(parser, TOKEN_OPEN_PARENTHESES) == true) {
     uint8_t count = arguments(parser);
 
     EMIT_BYTE(parser, OP_INVOKE);
-    EMIT_BYTE(parser, property);
+    emit_index(parser, property);
 
     EMIT_BYTE(parser, count);
+    cache(parser);
   }
   else {
     EMIT_BYTE(parser, OP_PROPERTY_GET);
-    EMIT_BYTE(parser, property);
+    emit_index(parser, property);
+    cache(parser);
   }
 }
 
@@ -720,18 +1077,33 @@ static void super(Parser* parser, bool assign) {
   consume(parser, TOKEN_DOT, compile_time_errors[EXPECT_DOT_AFTER_SUPER]);
   consume(parser, TOKEN_IDENTIFIER, compile_time_errors[EXPECT_SUPERCLASS_PROPERTY]);
   
-  uint8_t identifier = identify(parser, &parser->previous);
+  uint16_t identifier = identify(parser, &parser->previous);
 
   emit_assignment(parser, synthetic("this"), false);
+
+  if (match(parser, TOKEN_OPEN_PARENTHESES) == true) {
+    uint8_t count = arguments(parser);
+
+    emit_assignment(parser, synthetic("super"), false);
+
+    EMIT_BYTE(parser, OP_SUPER_INVOKE);
+    emit_index(parser, identifier);
+
+    EMIT_BYTE(parser, count);
+    cache(parser);
+
+    return;
+  }
+
   emit_assignment(parser, synthetic("super"), false);
 
   EMIT_BYTE(parser, OP_SUPER);
-  EMIT_BYTE(parser, identifier);
+  emit_index(parser, identifier);
 }
 
 static void set(Parser* parser, bool force) {
   do {
-    uint8_t global = definition(parser, compile_time_errors[EXPECT_VARIABLE_IDENTIFIER], force);
+    int global = definition(parser, compile_time_errors[EXPECT_VARIABLE_IDENTIFIER], force);
 
     if (match(parser, TOKEN_COLON))
       expression(parser);
@@ -744,7 +1116,7 @@ static void set(Parser* parser, bool force) {
 }
 
 static void define(Parser* parser, bool force) {
-  uint8_t global = definition(parser, compile_time_errors[EXPECT_FUNCTION_IDENTIFIER], force);
+  int global = definition(parser, compile_time_errors[EXPECT_FUNCTION_IDENTIFIER], force);
   mark(parser, force);
   emit_function(parser, POSITION_FUNCTION, false);
   initialize(parser, global, force);
@@ -755,14 +1127,14 @@ static void class(Parser* parser, bool force) {
 
   Token class = parser->previous;
 
-  uint8_t constant = identify(parser, &parser->previous);
+  uint16_t constant = identify(parser, &parser->previous);
 
   declaration(parser, force);
 
   EMIT_BYTE(parser, OP_CLASS);
-  EMIT_BYTE(parser, constant);
+  emit_index(parser, constant);
   
-  initialize(parser, constant, force);
+  initialize(parser, parser->compiler->scope == 0 || force == true ? resolve_global(parser, &class) : 0, force);
 
   Entity entity;
 
@@ -809,14 +1181,14 @@ static void class(Parser* parser, bool force) {
         do {
           consume(parser, TOKEN_IDENTIFIER, compile_time_errors[EXPECT_MEMBER_IDENTIFIER]);
 
-          uint8_t constant = identify(parser, &parser->previous);
+          uint16_t constant = identify(parser, &parser->previous);
 
           if (match(parser, TOKEN_COLON) == true)
             expression(parser);
           else EMIT_BYTE(parser, OP_UNDEFINED);
 
           EMIT_BYTE(parser, OP_MEMBER);
-          EMIT_BYTE(parser, constant);
+          emit_index(parser, constant);
         } while(match(parser, TOKEN_COMMA) == true);
 
         consume(parser, TOKEN_SEMICOLON, compile_time_errors[EXPECT_SEMICOLON]);
@@ -833,12 +1205,12 @@ static void class(Parser* parser, bool force) {
 
         consume(parser, TOKEN_IDENTIFIER, compile_time_errors[EXPECT_METHOD_IDENTIFIER]);
 
-        uint8_t constant = identify(parser, &parser->previous);
+        uint16_t constant = identify(parser, &parser->previous);
 
         emit_function(parser, position, false);
 
         EMIT_BYTE(parser, OP_METHOD);
-        EMIT_BYTE(parser, constant);
+        emit_index(parser, constant);
       }
     }
 
@@ -858,6 +1230,32 @@ static void conditional(Parser* parser) {
 
   consume(parser, TOKEN_COLON, compile_time_errors[EXPECT_COLON_CONDITION]);
 
+  int condition = foldable(parser);
+
+  if (condition != INITIALIZE) {
+    bool taken = falsey(evaluate(GET_CURRENT_CHUNK(parser->compiler), condition)) == false;
+
+    retract(parser, condition);
+
+    statement(parser);
+
+    if (taken == false)
+      retract(parser, condition);
+
+    if (match(parser, TOKEN_ELSE)) {
+      consume(parser, TOKEN_COLON, compile_time_errors[EXPECT_COLON_STATEMENT]);
+
+      int otherwise = GET_CURRENT_CHUNK(parser->compiler)->count;
+
+      statement(parser);
+
+      if (taken == true)
+        retract(parser, otherwise);
+    }
+
+    return;
+  }
+
   int then = jump(parser, OP_JUMP_CONDITIONAL);
 
   EMIT_BYTE(parser, OP_POP);
@@ -886,6 +1284,22 @@ static void iterative(Parser* parser) {
 
   consume(parser, TOKEN_COLON, compile_time_errors[EXPECT_COLON_CONDITION]);
 
+  int condition = foldable(parser);
+
+  if (condition != INITIALIZE) {
+    bool taken = falsey(evaluate(GET_CURRENT_CHUNK(parser->compiler), condition)) == false;
+
+    retract(parser, condition);
+
+    statement(parser);
+
+    if (taken == true)
+      loop(parser, start);
+    else retract(parser, start);
+
+    return;
+  }
+
   int exit = jump(parser, OP_JUMP_CONDITIONAL);
 
   EMIT_BYTE(parser, OP_POP);
@@ -954,7 +1368,7 @@ static void looping(Parser* parser) {
 
     expression(parser);
 
-    EMIT_BYTE(parser, OP_POP);
+    discard(parser);
 
     consume(parser, TOKEN_CLOSE_PARENTHESES, compile_time_errors[EXPECT_CLOSE_FOR]);
 
@@ -1003,14 +1417,28 @@ static void expression(Parser* parser) {
   parse(parser, PRECEDENCE_ASSIGNMENT);
 }
 
+static bool ending(Parser* parser) {
+  return check(parser, TOKEN_RETURN) || check(parser, TOKEN_EXIT);
+}
+
 static void block(Parser* parser) {
+  int dead = INITIALIZE;
+
   while (check(parser, TOKEN_CLOSE_BRACES) == false) {
     if (check(parser, TOKEN_EOF) == true)
       break;
 
+    bool last = ending(parser);
+
     instruction(parser);
+
+    if (last == true && dead == INITIALIZE)
+      dead = GET_CURRENT_CHUNK(parser->compiler)->count;
   }
 
+  if (dead != INITIALIZE)
+    retract(parser, dead);
+
   consume(parser, TOKEN_CLOSE_BRACES, compile_time_errors[EXPECT_BLOCK]);
 }
 
@@ -1055,7 +1483,7 @@ static void statement(Parser* parser) {
   }
   else {
     expression(parser);
-    EMIT_BYTE(parser, OP_POP);
+    discard(parser);
     consume(parser, TOKEN_SEMICOLON, compile_time_errors[EXPECT_SEMICOLON]);
   }
 }
@@ -1109,7 +1537,7 @@ static void parse(Parser* parser, Precedences precedence) {
     error(parser, parser->previous, compile_time_errors[INVALID_ASSIGNMENT_TARGET]);
 }
 
-Function* compile(VM* vm, const char* source) {
+Function* compile(VM* vm, const char* source, size_t length) {
   Parser parser; 
 
   parser.vm = vm;
@@ -1119,7 +1547,9 @@ Function* compile(VM* vm, const char* source) {
 
   parser.panic = false; parser.error = false;
 
-  set_tokenizer(&parser.tokenizer, source);
+  vm->parser = &parser;
+
+  set_tokenizer(&parser.tokenizer, source, length);
 
   advance(&parser);
 
@@ -1127,10 +1557,23 @@ Function* compile(VM* vm, const char* source) {
 
   set_compiler(&parser, &compiler, POSITION_SCRIPT);
   
-  while (match(&parser, TOKEN_EOF) == false)
+  int dead = INITIALIZE;
+
+  while (match(&parser, TOKEN_EOF) == false) {
+    bool last = ending(&parser);
+
     instruction(&parser);
 
-  if (parser.error == false)
-    return terminate(&parser);
-  else return NULL;
+    if (last == true && dead == INITIALIZE)
+      dead = GET_CURRENT_CHUNK(parser.compiler)->count;
+  }
+
+  if (dead != INITIALIZE)
+    retract(&parser, dead);
+
+  Function* function = terminate(&parser);
+
+  vm->parser = NULL;
+
+  return parser.error == false ? function : NULL;
 }
\ No newline at end of file
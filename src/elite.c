@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "elite.h"
+#include "compiler.h"
+#include "utilities/memory.h"
+
+VM* create_VM(Settings* settings) {
+  Settings defaults;
+
+  if (settings == NULL) {
+    set_settings(&defaults);
+    settings = &defaults;
+  }
+
+  VM* vm = malloc(sizeof(VM));
+
+  if (vm == NULL) exit(1);
+
+  initialize_VM(vm, settings);
+
+  return vm;
+}
+
+void destroy_VM(VM* vm) {
+  free_VM(vm);
+  free(vm);
+}
+
+Function* load_script(VM* vm, const char* source) {
+  Function* script = compile(vm, source, strlen(source));
+
+  if (script == NULL) return NULL;
+
+  Parents* scripts = &vm->scripts;
+
+  if (scripts->capacity < scripts->count + 1) {
+    scripts->capacity = GROW_CAPACITY(scripts->capacity);
+
+    Object** content = realloc(scripts->content, sizeof(Object*) * scripts->capacity);
+
+    if (content == NULL) exit(1);
+
+    scripts->content = content;
+  }
+
+  scripts->content[scripts->count++] = (Object*)script;
+
+  return script;
+}
+
+void unload_script(VM* vm, Function* script) {
+  Parents* scripts = &vm->scripts;
+
+  for (int i = 0; i < scripts->count; i++)
+    if (scripts->content[i] == (Object*)script) {
+      scripts->content[i] = scripts->content[--scripts->count];
+      return;
+    }
+}
+
+void set_global(VM* vm, const char* identifier, Value value) {
+  push(&vm->stack, value);
+  push(&vm->stack, OBJECT(copy_string(vm, identifier, (int)strlen(identifier))));
+
+  int slot = global_slot(vm, AS_STRING(peek(&vm->stack, 0)));
+
+  vm->globals.values[slot] = peek(&vm->stack, 1);
+
+  pop(&vm->stack, 2);
+}
+
+bool get_global(VM* vm, const char* identifier, Value* value) {
+  String* string = copy_string(vm, identifier, (int)strlen(identifier));
+
+  Value slot;
+
+  if (table_get(&vm->globals.slots, string, &slot) == false)
+    return false;
+
+  Value* content = &vm->globals.values[AS_INTEGER(slot)];
+
+  if (IS_VACANT(*content))
+    return false;
+
+  if (IS_ROPE(*content))
+    *content = OBJECT(flatten(vm, AS_ROPE(*content)));
+
+  *value = *content;
+
+  return true;
+}
@@ -20,12 +20,64 @@ static int constant_representation(const char* name, Chunk* chunk, int offset) {
   return offset + 2;
 }
 
+static int long_representation(const char* name, Chunk* chunk, int offset) {
+  uint16_t constant = (uint16_t)(chunk->code[offset + 1] << 8);
+  constant |= chunk->code[offset + 2];
+
+  printf("%s - %d - ", name, constant);
+  print_value(chunk->constants.values[constant]);
+  printf("\n");
+
+  return offset + 3;
+}
+
+static int slot_representation(const char* name, Chunk* chunk, int offset) {
+  uint16_t slot = (uint16_t)(chunk->code[offset + 1] << 8);
+  slot |= chunk->code[offset + 2];
+
+  printf("%-16s %4d\n", name, slot);
+
+  return offset + 3;
+}
+
 static int byte_representation(const char* name, Chunk* chunk, int offset) {
   uint8_t slot = chunk->code[offset + 1];
   printf("%-16s %4d\n", name, slot);
   return offset + 2; 
 }
 
+static int cache_representation(const char* name, Chunk* chunk, int offset) {
+  uint16_t constant = (uint16_t)(chunk->code[offset + 1] << 8);
+  constant |= chunk->code[offset + 2];
+
+  uint16_t index = (uint16_t)(chunk->code[offset + 3] << 8);
+  index |= chunk->code[offset + 4];
+
+  Cache* cache = &chunk->caches.content[index];
+
+  printf("%s - %d - ", name, constant);
+  print_value(chunk->constants.values[constant]);
+  printf(" - cache %d (%s)\n", index, cache->megamorphic ? "megamorphic" : cache->count > 1 ? "polymorphic" : cache->count == 1 ? "monomorphic" : "empty");
+
+  return offset + 5;
+}
+
+static int register_representation(const char* name, Chunk* chunk, int offset, bool constant) {
+  uint8_t left = chunk->code[offset + 1];
+  uint8_t right = chunk->code[offset + 2];
+
+  printf("%-16s %4d ", name, left);
+
+  if (constant == true) {
+    printf("- %d - ", right);
+    print_value(chunk->constants.values[right]);
+    printf("\n");
+  }
+  else printf("%4d\n", right);
+
+  return offset + 3;
+}
+
 static int jump_representation(const char* name, int sign, Chunk* chunk, int offset) {
   uint16_t jump = (uint16_t)(chunk->code[offset + 1] << 8);
   jump |= chunk->code[offset + 2];
@@ -56,8 +108,11 @@ int disassemble_instruction(Chunk* chunk, int offset) {
   switch (instruction) {
     case OP_LOOP:
     case OP_LOOP_CONDITIONAL:
+      return jump_representation(strings[instruction], -1, chunk, offset);
+
     case OP_JUMP:
     case OP_JUMP_CONDITIONAL:
+    case OP_LESS_JUMP:
       return jump_representation(strings[instruction], 1, chunk, offset);
 
     case OP_LOCAL_SET:
@@ -65,19 +120,49 @@ int disassemble_instruction(Chunk* chunk, int offset) {
     case OP_UP_SET:
     case OP_UP_GET:
     case OP_CALL:
+    case OP_POP_N:
+    case OP_REGISTER_STORE:
+    case OP_INCREMENT_LOCAL:
+    case OP_DECREMENT_LOCAL:
       return byte_representation(strings[instruction], chunk, offset);
 
     case OP_CONSTANT:
+      return constant_representation(strings[instruction], chunk, offset);
+
+    case OP_CONSTANT_LONG:
+    case OP_CLASS:
+    case OP_MEMBER:
+    case OP_METHOD:
+    case OP_SUPER:
+      return long_representation(strings[instruction], chunk, offset);
+
     case OP_GLOBAL_INITIALIZE:
     case OP_GLOBAL_SET:
     case OP_GLOBAL_GET:
-    case OP_CLASS:
+      return slot_representation(strings[instruction], chunk, offset);
+
     case OP_PROPERTY_SET:
     case OP_PROPERTY_GET:
-    case OP_MEMBER:
-    case OP_METHOD:
-    case OP_SUPER:
-      return constant_representation(strings[instruction], chunk, offset);
+      return cache_representation(strings[instruction], chunk, offset);
+
+    case OP_REGISTER_ADD:
+    case OP_REGISTER_SUBTRACT:
+    case OP_REGISTER_MULTIPLY:
+    case OP_REGISTER_DIVIDE:
+    case OP_REGISTER_EQUAL:
+    case OP_REGISTER_GREATER:
+    case OP_REGISTER_LESS:
+    case OP_REGISTER_MOVE:
+      return register_representation(strings[instruction], chunk, offset, false);
+
+    case OP_REGISTER_ADD_CONSTANT:
+    case OP_REGISTER_SUBTRACT_CONSTANT:
+    case OP_REGISTER_MULTIPLY_CONSTANT:
+    case OP_REGISTER_DIVIDE_CONSTANT:
+    case OP_REGISTER_EQUAL_CONSTANT:
+    case OP_REGISTER_GREATER_CONSTANT:
+    case OP_REGISTER_LESS_CONSTANT:
+      return register_representation(strings[instruction], chunk, offset, true);
 
     case OP_TRUE:
     case OP_FALSE:
@@ -93,8 +178,10 @@ int disassemble_instruction(Chunk* chunk, int offset) {
     case OP_EQUAL:
     case OP_GREATER:
     case OP_LESS:
+    case OP_NOT_EQUAL:
+    case OP_GREATER_EQUAL:
+    case OP_LESS_EQUAL:
     case OP_POP:
-    case OP_POP_N:
     case OP_CLOSE:
     case OP_INHERIT:
     case OP_RETURN:
@@ -102,21 +189,44 @@ int disassemble_instruction(Chunk* chunk, int offset) {
     case OP_EXIT:
       return simple_representation(strings[instruction], offset);
 
-    case OP_INVOKE: {
-      uint8_t constant = chunk->code[offset + 1];
-      uint8_t count = chunk->code[offset + 2];
+    case OP_INVOKE:
+    case OP_SUPER_INVOKE: {
+      uint16_t constant = (uint16_t)(chunk->code[offset + 1] << 8);
+      constant |= chunk->code[offset + 2];
+
+      uint8_t count = chunk->code[offset + 3];
       
+      uint16_t index = (uint16_t)(chunk->code[offset + 4] << 8);
+      index |= chunk->code[offset + 5];
+
       printf("%-16s (%d args) %4d '", strings[instruction], count, constant);
       print_value(chunk->constants.values[constant]);
-      printf("'\n");
+      printf("' - cache %d\n", index);
+
+      return offset + 6;
+    }
+
+    case OP_LOCAL_GET_PROPERTY: {
+      uint8_t slot = chunk->code[offset + 1];
+
+      uint16_t constant = (uint16_t)(chunk->code[offset + 2] << 8);
+      constant |= chunk->code[offset + 3];
+
+      uint16_t index = (uint16_t)(chunk->code[offset + 4] << 8);
+      index |= chunk->code[offset + 5];
+
+      printf("%-16s %4d - %d - ", strings[instruction], slot, constant);
+      print_value(chunk->constants.values[constant]);
+      printf(" - cache %d\n", index);
 
-      return offset + 3;
+      return offset + 6;
     }
 
     case OP_CLOSURE: {
       offset++;
       
-      uint8_t constant = chunk->code[offset++];
+      uint16_t constant = (uint16_t)(chunk->code[offset++] << 8);
+      constant |= chunk->code[offset++];
 
       printf("%-16s %4d ", strings[instruction], constant);
       print_value(chunk->constants.values[constant]);
@@ -1,6 +1,9 @@
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "helpers/generic.h"
 
@@ -44,8 +47,10 @@ const char* compile_time_errors[] = {
   [MINIMUM_CAPACITY_LOOP_BODY] = "Loop body too large.",
   [MUST_HAVE_SUPERCLASS] = "Cannot use 'super' in a class final no superclass.",
   [TOO_MANY_CONSTANTS] = "Too many Constants in one single Chunk.",
+  [TOO_MANY_CACHES] = "Too many property accesses in one single Chunk.",
   [TOO_MANY_LOCALS] = "Too many local variables in Function.",
   [TOO_MANY_CLOSURE_VARIABLES] = "Too many closure variables in Function.",
+  [TOO_MANY_GLOBALS] = "Too many global variables.",
   [VARIABLE_ALREADY_DECLARE] = "A variable final this identifier has already been declared in this scope."
 };
 
@@ -62,51 +67,137 @@ const char* run_time_errors[] = {
   [MUST_BE_STRINGS] = "Operands must be Strings.",
   [MUST_BE_NUMBER_OR_STRING] = "Operand must be a Number or a String.",
   [MUST_BE_NUMBERS_OR_STRINGS] = "Operands must be two Numbers or two Strings.",
+  [MUST_BE_POSITIVE_INTEGER] = "Operand must be a positive Integer.",
   [STACK_OVERFLOW] = "A Stack Overflow error has occured.",
   [UNDEFINED_VARIABLE] = "Undefined variable '%s'.",
   [UNDEFINED_ERROR] = "Undefined Error Message.",
   [UNDEFINED_METHOD] = "Undefined method '%s'.",
-  [UNDEFINED_PROPERTY] = "Undefined property '%s'."
+  [UNDEFINED_PROPERTY] = "Undefined property '%s'.",
+  [UNDEFINED_STATISTIC] = "Undefined collector statistic '%s'.",
+  [UNDEFINED_COUNTER] = "Undefined cache counter '%s'.",
+  [UNDEFINED_TABLE] = "Undefined table '%s'.",
+  [UNDEFINED_PROBE] = "Undefined probe statistic '%s'."
 };
 
 const char* read_file_errors[] = {
   [CANNOT_OPEN_FILE] = "Could not open file <%s>.",
   [CANNOT_READ_FILE] = "Could not read file <%s>.",
+  [CANNOT_WRITE_FILE] = "Could not write file <%s>.",
   [NOT_ENOUGH_MEMORY] = "Not enough memory to read file."
 };
 
-char* read(const char* path, int* error) {
-  FILE* file = fopen(path, "rb");
+#define STREAM_CHUNK 4096
+
+// Pipes, terminals and other files that are not regular cannot be mapped and
+// have no size, so they are read to their end and the bytes copied into an
+// anonymous mapping, which unmap_file releases like any other.
+static const char* read_stream(FILE* file, size_t* size, int* error) {
+  size_t capacity = STREAM_CHUNK, count = 0;
+
+  char* buffer = malloc(capacity);
+
+  if (buffer == NULL) {
+    *error = NOT_ENOUGH_MEMORY;
+    return NULL;
+  }
 
-  if (file) {
-    fseek(file, 0L, SEEK_END);
-    size_t size = ftell(file);
-    rewind(file);
+  size_t bytes;
 
-    char* buffer = (char*)malloc(size + 1);
+  while ((bytes = fread(buffer + count, sizeof(char), capacity - count, file)) > 0) {
+    count += bytes;
 
-    if (buffer) {
-      size_t bytes = fread(buffer, sizeof(char), size, file);
+    if (count == capacity) {
+      char* grown = realloc(buffer, capacity * 2);
 
-      if (bytes >= size) {
-        buffer[bytes] = '\0';
+      if (grown == NULL) {
+        free(buffer);
 
-        fclose(file);
-        
-        return buffer;
+        *error = NOT_ENOUGH_MEMORY;
+        return NULL;
       }
 
-      error = (int*)NOT_ENOUGH_MEMORY;
-    
-      return NULL;
+      buffer = grown;
+      capacity *= 2;
     }
+  }
 
-    error = (int*)CANNOT_READ_FILE;
+  if (ferror(file)) {
+    free(buffer);
 
+    *error = CANNOT_READ_FILE;
     return NULL;
   }
 
-  error = (int*)CANNOT_OPEN_FILE;
+  *size = count;
+
+  if (count == 0) {
+    free(buffer);
+    return "";
+  }
+
+  void* content = mmap(NULL, count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (content == MAP_FAILED) {
+    free(buffer);
+
+    *error = NOT_ENOUGH_MEMORY;
+    return NULL;
+  }
+
+  memcpy(content, buffer, count);
+
+  free(buffer);
+
+  return content;
+}
+
+const char* map_file(const char* path, size_t* size, int* error) {
+  FILE* file = fopen(path, "rb");
+
+  struct stat status;
+
+  if (file == NULL) {
+    *error = CANNOT_OPEN_FILE;
+    return NULL;
+  }
+
+  if (fstat(fileno(file), &status) != 0) {
+    fclose(file);
+
+    *error = CANNOT_READ_FILE;
+    return NULL;
+  }
+
+  if (S_ISREG(status.st_mode) == false) {
+    const char* content = read_stream(file, size, error);
+
+    fclose(file);
+
+    return content;
+  }
+
+  *size = status.st_size;
+
+  if (*size == 0) {
+    fclose(file);
+    return "";
+  }
+
+  void* content = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+
+  fclose(file);
+
+  if (content == MAP_FAILED) {
+    *error = CANNOT_READ_FILE;
+    return NULL;
+  }
+
+  madvise(content, *size, MADV_SEQUENTIAL);
+
+  return content;
+}
 
-  return NULL;
-}
\ No newline at end of file
+void unmap_file(const char* content, size_t size) {
+  if (size != 0)
+    munmap((void*)content, size);
+}
@@ -5,18 +5,31 @@
 #include "common.h"
 
 #include "vm.h"
+#include "runner.h"
 
 #define VERSION \
   "Elite 1.0.0\n" \
   "Repository: https://github.com/Davi0k/elite\n" \
   "About me: https://davide.codes\n"
 
+#define SYNTAX \
+  "elite [path...] [-j jobs] [-c] [-v] [-h] [-f] [-i] [-r] [-d] [-p bits] [-s values] [-l values]"
+
 #define HELP \
-  "Usage: elite [path] [-v] [-h]\n" \
-  "\tpath: The path of the script you want to execute.\n" \
+  "Usage: " SYNTAX "\n" \
+  "\tpath: The path of the script you want to execute, or with -j and -c, of any number of scripts and directories of scripts.\n" \
   "Options:\n" \
   "\t-v: Returns the current interpreter's version.\n" \
-  "\t-h: Returns a list of the available settings and options for the interpreter.\n"
+  "\t-c: Compiles every script, and every script in a directory, to a bytecode cache next to it, script.elc, without running it, on the worker threads of -j if given. Scripts whose cache is up to date load it instead of compiling.\n" \
+  "\t-h: Returns a list of the available settings and options for the interpreter.\n" \
+  "\t-j: Runs every script on a pool of jobs worker threads, each script with its own VM, and reports their exit codes and timings.\n" \
+  "\t-f: Uses hardware doubles for non-integer Numbers, only big() creates arbitrary precision Numbers.\n" \
+  "\t-i: Uses the incremental garbage collector instead of the generational one.\n" \
+  "\t-r: Compiles to the register-based instruction set, whose operations read their operands straight from local slots.\n" \
+  "\t-d: Prints the disassembly of every compiled function, after folding and optimization.\n" \
+  "\t-p: Sets the precision, in bits, of arbitrary precision Numbers.\n" \
+  "\t-s: Sets the initial size, in values, of the stack.\n" \
+  "\t-l: Sets the maximum size, in values, the stack can grow to before a Stack Overflow error.\n"
 
 static void repl(VM* vm) {
   size_t size = 0;
@@ -36,68 +49,156 @@ static void repl(VM* vm) {
 }
 
 static void file(VM* vm, const char* path) {
-  int code = 0;
+  int code = run_file(vm, path);
+
+#ifdef COUNT_INSTRUCTIONS
+  if (code != EXIT_FILE_ERROR)
+    fprintf(stderr, "Instructions: %zu\n", vm->counters.instructions);
+#endif
+
+  if (code != 0) exit(code);
+}
+
+static void usage() {
+  fprintf(stderr, "The correct syntax is: " SYNTAX "\n");
+  exit(64);
+}
 
-  char* source = read(path, &code);
+int main(int argc, const char* argv[]) {
+  Settings settings;
+
+  set_settings(&settings);
+
+  const char** paths = malloc(sizeof(char*) * argc);
 
-  if (source == NULL) {
-    switch (code) {
-      case CANNOT_OPEN_FILE:
-        fprintf(stderr, read_file_errors[CANNOT_OPEN_FILE], path);
-        exit(74);
+  int count = 0, jobs = 0;
 
-      case CANNOT_READ_FILE:
-        fprintf(stderr, read_file_errors[CANNOT_READ_FILE], path);
-        exit(74);
+  bool emit = false;
 
-      case NOT_ENOUGH_MEMORY:
-        fprintf(stderr, read_file_errors[NOT_ENOUGH_MEMORY]);
-        exit(74);
+  for (int i = 1; i < argc; i++) {
+    const char* parameter = argv[i];
+
+    if (parameter[0] != '-') {
+      paths[count++] = parameter;
+
+      continue;
     }
-  }
 
-  Results result = interpret(vm, source);
+    switch (parameter[1]) {
+      case 'v':
+      case 'V':
+        printf(VERSION);
+        return 0;
 
-  free(source);
+      case 'h':
+      case 'H': 
+        printf(HELP);
+        return 0;
 
-  if (result == INTERPRET_COMPILE_ERROR) exit(65);
-  if (result == INTERPRET_RUNTIME_ERROR) exit(70);
-}
+      case 'c':
+      case 'C':
+        emit = true;
+        break;
 
-int main(int argc, const char* argv[]) {
-  mpf_set_default_prec(GMP_MAX_PRECISION);
+      case 'j':
+      case 'J': {
+        if (i + 1 == argc) usage();
 
-  VM vm;
+        long workers = strtol(argv[++i], NULL, 10);
+
+        if (workers <= 0 || workers > INT16_MAX) usage();
+
+        jobs = (int)workers;
+
+        break;
+      }
+
+      case 'f':
+      case 'F':
+        settings.numerics = NUMERICS_FAST;
+        break;
+
+      case 'i':
+      case 'I':
+        settings.collector = COLLECTOR_INCREMENTAL;
+        break;
+
+      case 'r':
+      case 'R':
+        settings.tier = TIER_REGISTER;
+        break;
+
+      case 'd':
+      case 'D':
+        settings.disassemble = true;
+        break;
 
-  initialize_VM(&vm);
+      case 'p':
+      case 'P': {
+        if (i + 1 == argc) usage();
 
-  if (argc == 1) repl(&vm);
+        long precision = strtol(argv[++i], NULL, 10);
 
-  if (argc == 2)  {
-    const char* parameter = argv[1];
+        if (precision <= 0) usage();
 
-    if (parameter[0] == '-') {
-      switch (parameter[1]) {
-        case 'v':
-        case 'V':
-          printf(VERSION);
-          break;
+        settings.precision = (mp_bitcnt_t)precision;
 
-        case 'h':
-        case 'H': 
-          printf(HELP);
-          break;
+        break;
       }
+
+      case 's':
+      case 'S': {
+        if (i + 1 == argc) usage();
+
+        long size = strtol(argv[++i], NULL, 10);
+
+        if (size <= 0 || size > INT32_MAX) usage();
+
+        settings.stack = (size_t)size;
+
+        break;
+      }
+
+      case 'l':
+      case 'L': {
+        if (i + 1 == argc) usage();
+
+        long limit = strtol(argv[++i], NULL, 10);
+
+        if (limit <= 0 || limit > INT32_MAX) usage();
+
+        settings.limit = (size_t)limit;
+
+        break;
+      }
+
+      default: usage();
     }
-    else file(&vm, argv[1]);
   }
 
-  if (argc != 1 && argc != 2) {
-    fprintf(stderr, "The correct syntax is: elite [path] [-v] [-h]");
-    exit(64);
+  if (emit == true || jobs != 0) {
+    if (count == 0) usage();
+
+    int code = jobs != 0 ? run_jobs(&settings, paths, count, jobs, emit) : compile_files(&settings, paths, count);
+
+    free(paths);
+
+    return code;
   }
 
+  if (count > 1) usage();
+
+  VM vm;
+
+  initialize_VM(&vm, &settings);
+
+  if (count == 0) 
+    repl(&vm);
+  else file(&vm, paths[0]);
+
   free_VM(&vm);
 
+  free(paths);
+
   return 0;
 }
\ No newline at end of file
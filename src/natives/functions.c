@@ -7,6 +7,8 @@
 #include "natives/functions.h"
 
 #include "types/object.h"
+#include "types/number.h"
+#include "utilities/memory.h"
 
 void load_native_function(VM* vm, const char* identifier, CFunction c_function) {
   String* string = copy_string(vm, identifier, (int)strlen(identifier));
@@ -14,7 +16,9 @@ void load_native_function(VM* vm, const char* identifier, CFunction c_function)
   push(&vm->stack, OBJECT(string));
   push(&vm->stack, OBJECT(new_native_function(vm, c_function, string)));
 
-  table_set(&vm->globals, AS_STRING(vm->stack.content[0]), vm->stack.content[1]);
+  int slot = global_slot(vm, AS_STRING(vm->stack.content[0]));
+
+  vm->globals.values[slot] = vm->stack.content[1];
 
   pop(&vm->stack, 2);
 }
@@ -26,13 +30,19 @@ void load_default_native_functions(VM* vm) {
   load_native_function(vm, "input", input_native);
   load_native_function(vm, "length", length_native);
   load_native_function(vm, "type", type_native);
+  load_native_function(vm, "precision", precision_native);
+  load_native_function(vm, "big", big_native);
+  load_native_function(vm, "collector", collector_native);
+  load_native_function(vm, "caches", caches_native);
+  load_native_function(vm, "probes", probes_native);
+  load_native_function(vm, "StringBuilder", builder_native);
 }
 
 Value stopwatch_native(int count, Value* arguments, Handler* handler) {
   if (count == 0) {
     double seconds = (double)clock() / CLOCKS_PER_SEC;
 
-    return OBJECT(allocate_number_from_double(handler->vm, seconds));
+    return DOUBLE(seconds);
   } 
 
   return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 0, count);
@@ -40,7 +50,7 @@ Value stopwatch_native(int count, Value* arguments, Handler* handler) {
 
 Value number_native(int count, Value* arguments, Handler* handler) {
   if (count == 0) 
-    return OBJECT(allocate_number_from_double(handler->vm, 0.0));
+    return INTEGER(0);
 
   if (count == 1) {
     Value argument = arguments[0];
@@ -49,7 +59,7 @@ Value number_native(int count, Value* arguments, Handler* handler) {
       return argument;
 
     if (IS_STRING(argument))
-      return OBJECT(allocate_number_from_string(handler->vm, AS_STRING(argument)->content));
+      return parse_number(handler->vm, AS_STRING(argument)->content);
 
     return throw(handler, run_time_errors[MUST_BE_NUMBER_OR_STRING], 0);
   }
@@ -80,7 +90,11 @@ Value input_native(int count, Value* arguments, Handler* handler) {
 
     ssize_t length = getline(&content, &size, stdin);
 
-    return OBJECT(copy_string(handler->vm, content, length - 1));
+    String* string = loose_string(handler->vm, content, length - 1);
+
+    free(content);
+
+    return OBJECT(string);
   } 
   
   return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 1, count);
@@ -91,7 +105,7 @@ Value length_native(int count, Value* arguments, Handler* handler) {
     Value value = arguments[0];
 
     if (IS_STRING(value) == true) 
-      return OBJECT(allocate_number_from_double(handler->vm, AS_STRING(value)->length));
+      return INTEGER(AS_STRING(value)->length);
     else return throw(handler, run_time_errors[MUST_BE_STRING], 0);
   } 
   
@@ -104,14 +118,12 @@ Value type_native(int count, Value* arguments, Handler* handler) {
 
     char* type = NULL;
 
-    switch (value.type) {
-      case VALUE_BOOLEAN: type = "boolean"; break;
-      case VALUE_VOID: type = "void"; break;
-      case VALUE_UNDEFINED: type = "undefined"; break;
-    }
+    if (IS_BOOLEAN(value) == true) type = "boolean";
+    if (IS_VOID(value) == true) type = "void";
+    if (IS_UNDEFINED(value) == true) type = "undefined";
+    if (IS_NUMBER(value) == true) type = "number";
 
-    if (value.type == VALUE_OBJECT) {
-      if (IS_NUMBER(value) == true) type = "number";
+    if (IS_OBJECT(value) == true) {
       if (IS_STRING(value) == true) type = "string";
       if (IS_FUNCTION(value) == true || IS_CLOSURE(value) == true) type = "function";
       if (IS_NATIVE_FUNCTION(value) == true) type = "native_function";
@@ -119,10 +131,204 @@ Value type_native(int count, Value* arguments, Handler* handler) {
       if (IS_INSTANCE(value) == true) type = "instance";
       if (IS_BOUND(value) == true) type = "method";
       if (IS_NATIVE_BOUND(value) == true) type = "native_method";
+      if (IS_BUILDER(value) == true) type = "string_builder";
     }
 
     return OBJECT(copy_string(handler->vm, type, strlen(type)));
   } 
   
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 1, count);
+}
+
+Value precision_native(int count, Value* arguments, Handler* handler) {
+  if (count == 0)
+    return INTEGER(handler->vm->settings.precision);
+
+  if (count == 1) {
+    Value argument = arguments[0];
+
+    if (IS_INTEGER(argument) == false || AS_INTEGER(argument) <= 0)
+      return throw(handler, run_time_errors[MUST_BE_POSITIVE_INTEGER], 0);
+
+    handler->vm->settings.precision = (mp_bitcnt_t)AS_INTEGER(argument);
+
+    free_table(&handler->vm->numbers);
+    initialize_table(&handler->vm->numbers, handler->vm);
+
+    return argument;
+  }
+
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 1, count);
+}
+
+Value big_native(int count, Value* arguments, Handler* handler) {
+  if (count == 1) {
+    Value argument = arguments[0];
+
+    if (IS_NUMBER_OBJECT(argument))
+      return argument;
+
+    if (IS_NUMBER(argument)) {
+      mpf_t number;
+
+      mpf_init2(number, GMP_IMMEDIATE_PRECISION);
+
+      to_gmp(argument, number);
+
+      Value result = OBJECT(allocate_number_from_gmp(handler->vm, number));
+
+      mpf_clear(number);
+
+      return result;
+    }
+
+    if (IS_STRING(argument))
+      return OBJECT(allocate_number_from_string(handler->vm, AS_STRING(argument)->content));
+
+    return throw(handler, run_time_errors[MUST_BE_NUMBER_OR_STRING], 0);
+  }
+
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 1, count);
+}
+
+Value collector_native(int count, Value* arguments, Handler* handler) {
+  if (count == 1) {
+    Value argument = arguments[0];
+
+    if (IS_STRING(argument) == false)
+      return throw(handler, run_time_errors[MUST_BE_STRING], 0);
+
+    Statistics* statistics = &handler->vm->statistics;
+
+    const char* key = AS_STRING(argument)->content;
+
+    if (strcmp(key, "minors") == 0) return INTEGER(statistics->minors);
+    if (strcmp(key, "majors") == 0) return INTEGER(statistics->majors);
+    if (strcmp(key, "slices") == 0) return INTEGER(statistics->slices);
+    if (strcmp(key, "promoted") == 0) return INTEGER(statistics->promoted);
+    if (strcmp(key, "freed") == 0) return INTEGER(statistics->freed);
+    if (strcmp(key, "pause") == 0) return DOUBLE(statistics->pause);
+    if (strcmp(key, "longest") == 0) return DOUBLE(statistics->longest);
+    if (strcmp(key, "total") == 0) return DOUBLE(statistics->total);
+    if (strcmp(key, "p99") == 0) return DOUBLE(percentile(statistics, 0.99));
+
+    return throw(handler, run_time_errors[UNDEFINED_STATISTIC], 1, key);
+  }
+
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 1, count);
+}
+
+Value caches_native(int count, Value* arguments, Handler* handler) {
+  if (count == 1) {
+    Value argument = arguments[0];
+
+    if (IS_STRING(argument) == false)
+      return throw(handler, run_time_errors[MUST_BE_STRING], 0);
+
+    Counters* counters = &handler->vm->counters;
+
+    const char* key = AS_STRING(argument)->content;
+
+    if (strcmp(key, "hits") == 0) return INTEGER(counters->hits);
+    if (strcmp(key, "misses") == 0) return INTEGER(counters->misses);
+    if (strcmp(key, "megamorphic") == 0) return INTEGER(counters->megamorphic);
+
+    return throw(handler, run_time_errors[UNDEFINED_COUNTER], 1, key);
+  }
+
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 1, count);
+}
+
+// While the incremental collector sweeps, the unmarked objects still on the
+// sweeping list are dead and their keys may already be freed.
+static void probe_objects(Object* object, const char* table, bool sweeping, Probes* probes) {
+  for (; object != NULL; object = object->next) {
+    if (sweeping == true && object->mark == false) continue;
+
+    if (object->type == OBJECT_CLASS) {
+      Class* class = (Class*)object;
+
+      if (strcmp(table, "fields") == 0) table_probes(&class->layout, probes);
+      if (strcmp(table, "methods") == 0) table_probes(&class->methods, probes);
+    }
+    else if (object->type == OBJECT_INSTANCE && ((Instance*)object)->dictionary != NULL) {
+      if (strcmp(table, "dictionaries") == 0) table_probes(((Instance*)object)->dictionary, probes);
+    }
+  }
+}
+
+static bool probe_tables(VM* vm, const char* table, Probes* probes) {
+  if (strcmp(table, "globals") == 0)
+    table_probes(&vm->globals.slots, probes);
+  else if (strcmp(table, "strings") == 0)
+    table_probes(&vm->strings, probes);
+  else if (strcmp(table, "numbers") == 0)
+    table_probes(&vm->numbers, probes);
+  else if (strcmp(table, "fields") == 0 || strcmp(table, "methods") == 0 || strcmp(table, "dictionaries") == 0) {
+    probe_objects(vm->objects, table, false, probes);
+    probe_objects(vm->old, table, false, probes);
+    probe_objects(vm->survivors, table, false, probes);
+    probe_objects(vm->sweeping, table, true, probes);
+  }
+  else return false;
+
+  return true;
+}
+
+Value probes_native(int count, Value* arguments, Handler* handler) {
+  if (count == 2) {
+    Value table = arguments[0], statistic = arguments[1];
+
+    if (IS_STRING(table) == false)
+      return throw(handler, run_time_errors[MUST_BE_STRING], 0);
+
+    Probes probes = { 0 };
+
+    if (probe_tables(handler->vm, AS_STRING(table)->content, &probes) == false)
+      return throw(handler, run_time_errors[UNDEFINED_TABLE], 1, AS_STRING(table)->content);
+
+    if (IS_INTEGER(statistic)) {
+      if (AS_INTEGER(statistic) < 0)
+        return throw(handler, run_time_errors[MUST_BE_POSITIVE_INTEGER], 0);
+
+      int64_t distance = AS_INTEGER(statistic);
+
+      return INTEGER(probes.histogram[distance < PROBE_BUCKETS ? distance : PROBE_BUCKETS - 1]);
+    }
+
+    if (IS_STRING(statistic) == false)
+      return throw(handler, run_time_errors[MUST_BE_NUMBER_OR_STRING], 0);
+
+    const char* key = AS_STRING(statistic)->content;
+
+    if (strcmp(key, "entries") == 0) return INTEGER(probes.entries);
+    if (strcmp(key, "longest") == 0) return INTEGER(probes.longest);
+    if (strcmp(key, "mean") == 0) return DOUBLE(probes.entries != 0 ? (double)probes.total / probes.entries : 0);
+
+    return throw(handler, run_time_errors[UNDEFINED_PROBE], 1, key);
+  }
+
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 2, count);
+}
+
+Value builder_native(int count, Value* arguments, Handler* handler) {
+  if (count == 0)
+    return OBJECT(new_builder(handler->vm));
+
+  if (count == 1) {
+    Value argument = arguments[0];
+
+    if (IS_STRING(argument) == false)
+      return throw(handler, run_time_errors[MUST_BE_STRING], 0);
+
+    String* string = AS_STRING(argument);
+
+    Builder* builder = new_builder(handler->vm);
+
+    append_builder(handler->vm, builder, string->content, string->length);
+
+    return OBJECT(builder);
+  }
+
   return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 1, count);
 }
\ No newline at end of file
@@ -4,17 +4,21 @@
 #include "natives/prototypes/object.h"
 #include "natives/prototypes/number.h"
 #include "natives/prototypes/string.h"
+#include "natives/prototypes/builder.h"
 
 #include "types/object.h"
 
 #include "vm.h"
 
 static void load_native_method(VM* vm, Prototype* prototype, const char* identifier, CMethod c_method) {
-  NativeMethod* native_method = new_native_method(vm, c_method, copy_string(vm, identifier, (int)strlen(identifier)));
+  String* string = copy_string(vm, identifier, (int)strlen(identifier));
 
-  String* name = copy_string(vm, identifier, (int)strlen(identifier));
+  push(&vm->stack, OBJECT(string));
+  push(&vm->stack, OBJECT(new_native_method(vm, c_method, string)));
 
-  table_set(&prototype->properties, name, OBJECT(native_method));
+  table_set(&prototype->properties, AS_STRING(vm->stack.content[0]), vm->stack.content[1]);
+
+  pop(&vm->stack, 2);
 }
 
 static void load_object_prototype(VM* vm, Prototype* prototype) {
@@ -33,23 +37,34 @@ static void load_string_prototype(VM* vm, Prototype* prototype) {
   load_native_method(vm, prototype, "lower", lower_string_method);
 }
 
+static void load_builder_prototype(VM* vm, Prototype* prototype) {
+  load_native_method(vm, prototype, "append", append_builder_method);
+  load_native_method(vm, prototype, "build", build_builder_method);
+  load_native_method(vm, prototype, "length", length_builder_method);
+  load_native_method(vm, prototype, "clear", clear_builder_method);
+}
+
 void load_default_native_methods(VM* vm) {
   load_object_prototype(vm, &vm->prototypes.object);
   load_object_prototype(vm, &vm->prototypes.number);
   load_object_prototype(vm, &vm->prototypes.string);
+  load_object_prototype(vm, &vm->prototypes.builder);
 
   load_number_prototype(vm, &vm->prototypes.number);
   load_string_prototype(vm, &vm->prototypes.string);
+  load_builder_prototype(vm, &vm->prototypes.builder);
 }
 
 void initialize_prototypes(VM* vm) {
   initialize_table(&vm->prototypes.object.properties, vm);
   initialize_table(&vm->prototypes.number.properties, vm);
   initialize_table(&vm->prototypes.string.properties, vm);
+  initialize_table(&vm->prototypes.builder.properties, vm);
 }
 
 void free_prototypes(VM* vm) {
   free_table(&vm->prototypes.object.properties);
   free_table(&vm->prototypes.number.properties);
   free_table(&vm->prototypes.string.properties);
+  free_table(&vm->prototypes.builder.properties);
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "natives/prototypes/builder.h"
+
+#include "types/object.h"
+
+Value append_builder_method(Value receiver, int count, Value* arguments, Handler* handler) {
+  if (count == 1) {
+    Value argument = arguments[0];
+
+    if (IS_STRING(argument) == false)
+      return throw(handler, run_time_errors[MUST_BE_STRING], 0);
+
+    String* string = AS_STRING(argument);
+
+    append_builder(handler->vm, AS_BUILDER(receiver), string->content, string->length);
+
+    return receiver;
+  }
+
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 1, count);
+}
+
+Value build_builder_method(Value receiver, int count, Value* arguments, Handler* handler) {
+  if (count == 0) {
+    Builder* builder = AS_BUILDER(receiver);
+
+    return OBJECT(loose_string(handler->vm, builder->length == 0 ? "" : builder->content, builder->length));
+  }
+
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 0, count);
+}
+
+Value length_builder_method(Value receiver, int count, Value* arguments, Handler* handler) {
+  if (count == 0)
+    return INTEGER(AS_BUILDER(receiver)->length);
+
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 0, count);
+}
+
+Value clear_builder_method(Value receiver, int count, Value* arguments, Handler* handler) {
+  if (count == 0) {
+    AS_BUILDER(receiver)->length = 0;
+
+    return receiver;
+  }
+
+  return throw(handler, run_time_errors[EXPECT_ARGUMENTS_NUMBER], 2, 0, count);
+}
\ No newline at end of file
@@ -1,18 +1,28 @@
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
+
+#include "vm.h"
 
 #include "natives/prototypes/number.h"
 
 #include "types/object.h"
+#include "types/number.h"
 
 Value truncate_number_method(Value receiver, int count, Value* arguments, Handler* handler) {  
   if (count == 0) {
+    if (IS_INTEGER(receiver) == true)
+      return receiver;
+
+    if (IS_DOUBLE(receiver) == true)
+      return normalize_double(trunc(AS_DOUBLE(receiver)));
+
     mpf_t truncate; 
     
-    mpf_init(truncate);
+    mpf_init2(truncate, handler->vm->settings.precision);
     mpf_trunc(truncate, AS_NUMBER(receiver)->content);
 
-    Value result = OBJECT(allocate_number_from_gmp(handler->vm, truncate));
+    Value result = normalize_number(handler->vm, truncate);
 
     mpf_clear(truncate);
 
@@ -24,12 +34,18 @@ Value truncate_number_method(Value receiver, int count, Value* arguments, Handle
 
 Value ceil_number_method(Value receiver, int count, Value* arguments, Handler* handler) {  
   if (count == 0) {
+    if (IS_INTEGER(receiver) == true)
+      return receiver;
+
+    if (IS_DOUBLE(receiver) == true)
+      return normalize_double(ceil(AS_DOUBLE(receiver)));
+
     mpf_t ceil; 
     
-    mpf_init(ceil);
+    mpf_init2(ceil, handler->vm->settings.precision);
     mpf_ceil(ceil, AS_NUMBER(receiver)->content);
 
-    Value result = OBJECT(allocate_number_from_gmp(handler->vm, ceil));
+    Value result = normalize_number(handler->vm, ceil);
 
     mpf_clear(ceil);
 
@@ -41,12 +57,18 @@ Value ceil_number_method(Value receiver, int count, Value* arguments, Handler* h
 
 Value floor_number_method(Value receiver, int count, Value* arguments, Handler* handler) {  
   if (count == 0) {
+    if (IS_INTEGER(receiver) == true)
+      return receiver;
+
+    if (IS_DOUBLE(receiver) == true)
+      return normalize_double(floor(AS_DOUBLE(receiver)));
+
     mpf_t floor; 
     
-    mpf_init(floor);
+    mpf_init2(floor, handler->vm->settings.precision);
     mpf_floor(floor, AS_NUMBER(receiver)->content);
 
-    Value result = OBJECT(allocate_number_from_gmp(handler->vm, floor));
+    Value result = normalize_number(handler->vm, floor);
 
     mpf_clear(floor);
 
@@ -7,6 +7,12 @@
 
 Value equals_object_method(Value receiver, int count, Value* arguments, Handler* handler) {
   if (count == 1) {
+    if (IS_OBJECT(receiver) == false || IS_OBJECT(arguments[0]) == false)
+      return BOOLEAN(equal(receiver, arguments[0]));
+
+    if (IS_STRING(receiver) == true && IS_STRING(arguments[0]) == true)
+      return BOOLEAN(equal(receiver, arguments[0]));
+
     Object* object = AS_OBJECT(receiver);
 
     if (object == AS_OBJECT(arguments[0]))
@@ -30,7 +30,9 @@ Value upper_string_method(Value receiver, int count, Value* arguments, Handler*
     if (string->content[0] == '\0')
       return UNDEFINED;
 
-    char* name = strtok(string->content, ":");
+    char* state;
+
+    char* name = strtok_r(string->content, ":", &state);
 
     char* character = name;
 
@@ -52,7 +54,9 @@ Value lower_string_method(Value receiver, int count, Value* arguments, Handler*
     if (string->content[0] == '\0')
       return UNDEFINED;
 
-    char* name = strtok(string->content, ":");
+    char* state;
+
+    char* name = strtok_r(string->content, ":", &state);
 
     char* character = name;
 
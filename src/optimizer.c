@@ -0,0 +1,238 @@
+#include <string.h>
+
+#include "vm.h"
+#include "compiler.h"
+#include "optimizer.h"
+#include "types/object.h"
+#include "utilities/memory.h"
+
+typedef struct {
+  int offset;
+  int target;
+} Jump;
+
+#define READ_SHORT(chunk, offset) \
+  ( (uint16_t)((chunk->code[offset + 1] << 8) | chunk->code[offset + 2]) )
+
+static int length(Chunk* chunk, int offset) {
+  switch (chunk->code[offset]) {
+    case OP_CONSTANT:
+    case OP_UP_SET:
+    case OP_UP_GET:
+    case OP_LOCAL_SET:
+    case OP_LOCAL_GET:
+    case OP_POP_N:
+    case OP_CALL:
+    case OP_REGISTER_STORE:
+    case OP_INCREMENT_LOCAL:
+    case OP_DECREMENT_LOCAL:
+      return 2;
+
+    case OP_LOOP:
+    case OP_LOOP_CONDITIONAL:
+    case OP_JUMP:
+    case OP_JUMP_CONDITIONAL:
+    case OP_LESS_JUMP:
+    case OP_CONSTANT_LONG:
+    case OP_CLASS:
+    case OP_MEMBER:
+    case OP_METHOD:
+    case OP_SUPER:
+    case OP_GLOBAL_INITIALIZE:
+    case OP_GLOBAL_SET:
+    case OP_GLOBAL_GET:
+    case OP_REGISTER_ADD:
+    case OP_REGISTER_ADD_CONSTANT:
+    case OP_REGISTER_SUBTRACT:
+    case OP_REGISTER_SUBTRACT_CONSTANT:
+    case OP_REGISTER_MULTIPLY:
+    case OP_REGISTER_MULTIPLY_CONSTANT:
+    case OP_REGISTER_DIVIDE:
+    case OP_REGISTER_DIVIDE_CONSTANT:
+    case OP_REGISTER_EQUAL:
+    case OP_REGISTER_EQUAL_CONSTANT:
+    case OP_REGISTER_GREATER:
+    case OP_REGISTER_GREATER_CONSTANT:
+    case OP_REGISTER_LESS:
+    case OP_REGISTER_LESS_CONSTANT:
+    case OP_REGISTER_MOVE:
+      return 3;
+
+    case OP_PROPERTY_SET:
+    case OP_PROPERTY_GET:
+      return 5;
+
+    case OP_INVOKE:
+    case OP_SUPER_INVOKE:
+    case OP_LOCAL_GET_PROPERTY:
+      return 6;
+
+    case OP_CLOSURE: {
+      Function* function = AS_FUNCTION(chunk->constants.values[READ_SHORT(chunk, offset)]);
+
+      return 3 + function->count * 2;
+    }
+
+    default: return 1;
+  }
+}
+
+static int destination(Chunk* chunk, int offset) {
+  switch (chunk->code[offset]) {
+    case OP_JUMP:
+    case OP_JUMP_CONDITIONAL:
+    case OP_LESS_JUMP:
+      return offset + 3 + READ_SHORT(chunk, offset);
+
+    case OP_LOOP:
+    case OP_LOOP_CONDITIONAL:
+      return offset + 3 - READ_SHORT(chunk, offset);
+
+    default: return INITIALIZE;
+  }
+}
+
+static bool one(Chunk* chunk, uint8_t constant) {
+  Value value = chunk->constants.values[constant];
+
+  return IS_INTEGER(value) && AS_INTEGER(value) == 1;
+}
+
+static bool straight(bool* targets, int start, int end) {
+  for (int i = start + 1; i < end; i++)
+    if (targets[i] == true) return false;
+
+  return true;
+}
+
+static int fuse(Chunk* chunk, bool* targets, int offset, uint8_t* fused, int* size, int* target) {
+  uint8_t* code = &chunk->code[offset];
+
+  int remaining = chunk->count - offset;
+
+  *target = INITIALIZE;
+
+  if (remaining >= 8 && code[0] == OP_LOCAL_GET && code[2] == OP_CONSTANT && (code[4] == OP_ADD || code[4] == OP_SUBTRACT))
+    if (code[5] == OP_LOCAL_SET && code[6] == code[1] && code[7] == OP_POP && one(chunk, code[3]) && straight(targets, offset, offset + 8)) {
+      fused[0] = code[4] == OP_ADD ? OP_INCREMENT_LOCAL : OP_DECREMENT_LOCAL;
+      fused[1] = code[1];
+      *size = 2;
+      return 8;
+    }
+
+  if (remaining >= 5 && (code[0] == OP_REGISTER_ADD_CONSTANT || code[0] == OP_REGISTER_SUBTRACT_CONSTANT))
+    if (code[3] == OP_REGISTER_STORE && code[4] == code[1] && one(chunk, code[2]) && straight(targets, offset, offset + 5)) {
+      fused[0] = code[0] == OP_REGISTER_ADD_CONSTANT ? OP_INCREMENT_LOCAL : OP_DECREMENT_LOCAL;
+      fused[1] = code[1];
+      *size = 2;
+      return 5;
+    }
+
+  if (remaining >= 2 && code[1] == OP_NOT && straight(targets, offset, offset + 2)) {
+    switch (code[0]) {
+      case OP_EQUAL: fused[0] = OP_NOT_EQUAL; *size = 1; return 2;
+      case OP_LESS: fused[0] = OP_GREATER_EQUAL; *size = 1; return 2;
+      case OP_GREATER: fused[0] = OP_LESS_EQUAL; *size = 1; return 2;
+    }
+  }
+
+  if (remaining >= 5 && code[0] == OP_LESS && code[1] == OP_JUMP_CONDITIONAL && code[4] == OP_POP) {
+    int end = destination(chunk, offset + 1);
+
+    if (end < chunk->count && chunk->code[end] == OP_POP && straight(targets, offset, offset + 5)) {
+      fused[0] = OP_LESS_JUMP;
+      *target = end + 1;
+      *size = 3;
+      return 5;
+    }
+  }
+
+  if (remaining >= 7 && code[0] == OP_LOCAL_GET && code[2] == OP_PROPERTY_GET && straight(targets, offset, offset + 7)) {
+    fused[0] = OP_LOCAL_GET_PROPERTY;
+    fused[1] = code[1];
+    memcpy(&fused[2], &code[3], 4);
+    *size = 6;
+    return 7;
+  }
+
+  return 0;
+}
+
+void optimize(Chunk* chunk) {
+  VM* vm = chunk->constants.vm;
+
+  int count = chunk->count;
+
+  bool* targets = ALLOCATE(vm, bool, count + 1);
+  int* map = ALLOCATE(vm, int, count + 1);
+  Jump* jumps = ALLOCATE(vm, Jump, count / 3 + 1);
+
+  memset(targets, false, sizeof(bool) * (count + 1));
+
+  for (int offset = 0; offset < count; offset += length(chunk, offset)) {
+    int target = destination(chunk, offset);
+
+    if (target == INITIALIZE) continue;
+
+    targets[target] = true;
+
+    if (chunk->code[offset] == OP_JUMP_CONDITIONAL && target < count && chunk->code[target] == OP_POP)
+      targets[target + 1] = true;
+  }
+
+  int written = 0, counter = 0;
+
+  for (int offset = 0; offset < count;) {
+    uint8_t fused[8];
+
+    int size, target;
+
+    int consumed = fuse(chunk, targets, offset, fused, &size, &target);
+
+    int line = chunk->lines[offset + (consumed == 0 ? 0 : consumed - 1)];
+
+    map[offset] = written;
+
+    if (consumed == 0) {
+      size = consumed = length(chunk, offset);
+
+      target = destination(chunk, offset);
+
+      memmove(&chunk->code[written], &chunk->code[offset], size);
+      memmove(&chunk->lines[written], &chunk->lines[offset], sizeof(int) * size);
+    }
+    else {
+      memcpy(&chunk->code[written], fused, size);
+
+      for (int i = 0; i < size; i++)
+        chunk->lines[written + i] = line;
+    }
+
+    if (target != INITIALIZE) {
+      jumps[counter].offset = written;
+      jumps[counter].target = target;
+      counter++;
+    }
+
+    written += size;
+    offset += consumed;
+  }
+
+  map[count] = written;
+
+  for (int i = 0; i < counter; i++) {
+    int offset = jumps[i].offset;
+    int target = map[jumps[i].target];
+
+    int jump = chunk->code[offset] == OP_LOOP || chunk->code[offset] == OP_LOOP_CONDITIONAL ? offset + 3 - target : target - offset - 3;
+
+    chunk->code[offset + 1] = (jump >> 8) & 0xff;
+    chunk->code[offset + 2] = jump & 0xff;
+  }
+
+  chunk->count = written;
+
+  FREE_ARRAY(vm, bool, targets, count + 1);
+  FREE_ARRAY(vm, int, map, count + 1);
+  FREE_ARRAY(vm, Jump, jumps, count / 3 + 1);
+}
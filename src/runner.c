@@ -0,0 +1,358 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "runner.h"
+#include "compiler.h"
+#include "utilities/cache.h"
+
+#define EXTENSION ".eli"
+
+typedef struct {
+  const char** content;
+  int count, capacity;
+} Paths;
+
+typedef struct {
+  Settings* settings;
+
+  bool emit;
+
+  Job* jobs;
+
+  Deque* deques;
+  int workers;
+} Runner;
+
+typedef struct {
+  Runner* runner;
+  int index;
+} Worker;
+
+static double now(clockid_t clock) {
+  struct timespec time;
+
+  clock_gettime(clock, &time);
+
+  return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static const char* load_source(const char* path, size_t* size) {
+  int code = 0;
+
+  const char* source = map_file(path, size, &code);
+
+  if (source == NULL) {
+    switch (code) {
+      case CANNOT_OPEN_FILE:
+      case CANNOT_READ_FILE:
+        fprintf(stderr, read_file_errors[code], path);
+        break;
+
+      case NOT_ENOUGH_MEMORY:
+        fprintf(stderr, read_file_errors[NOT_ENOUGH_MEMORY]);
+        break;
+    }
+
+    fputs("\n", stderr);
+  }
+
+  return source;
+}
+
+int run_file(VM* vm, const char* path) {
+  Function* function = vm->settings.disassemble == false ? load_cache(vm, path) : NULL;
+
+  if (function == NULL) {
+    char* original = source_path(path);
+
+    size_t size;
+
+    const char* source = load_source(original != NULL ? original : path, &size);
+
+    free(original);
+
+    if (source == NULL) return EXIT_FILE_ERROR;
+
+    function = compile(vm, source, size);
+
+    unmap_file(source, size);
+
+    if (function == NULL) return EXIT_COMPILE_ERROR;
+  }
+
+  Results result = execute(vm, function);
+
+  if (result == INTERPRET_RUNTIME_ERROR) return EXIT_RUNTIME_ERROR;
+
+  return 0;
+}
+
+int compile_file(VM* vm, const char* path) {
+  size_t size;
+
+  const char* source = load_source(path, &size);
+
+  if (source == NULL) return EXIT_FILE_ERROR;
+
+  Function* function = compile(vm, source, size);
+
+  int code = 0;
+
+  if (function == NULL)
+    code = EXIT_COMPILE_ERROR;
+  else if (write_cache(vm, function, path, source, size) == false) {
+    char* cache = cache_path(path);
+
+    fprintf(stderr, read_file_errors[CANNOT_WRITE_FILE], cache);
+    fputs("\n", stderr);
+
+    free(cache);
+
+    code = EXIT_FILE_ERROR;
+  }
+
+  unmap_file(source, size);
+
+  return code;
+}
+
+static void append(Paths* paths, char* path) {
+  if (paths->capacity < paths->count + 1) {
+    paths->capacity = paths->capacity < 8 ? 8 : paths->capacity * 2;
+
+    const char** content = realloc(paths->content, sizeof(char*) * paths->capacity);
+
+    if (content == NULL) exit(1);
+
+    paths->content = content;
+  }
+
+  paths->content[paths->count++] = path;
+}
+
+static int compare(const void* left, const void* right) {
+  return strcmp(*(const char**)left, *(const char**)right);
+}
+
+static void expand(Paths* paths, const char* path) {
+  struct stat status;
+
+  DIR* directory;
+
+  if (stat(path, &status) != 0 || S_ISDIR(status.st_mode) == false || (directory = opendir(path)) == NULL) {
+    char* copy = strdup(path);
+
+    if (copy == NULL) exit(1);
+
+    append(paths, copy);
+    return;
+  }
+
+  int first = paths->count;
+
+  size_t length = strlen(path);
+
+  struct dirent* entry;
+
+  while ((entry = readdir(directory)) != NULL) {
+    size_t size = strlen(entry->d_name);
+
+    if (size <= strlen(EXTENSION) || strcmp(entry->d_name + size - strlen(EXTENSION), EXTENSION) != 0)
+      continue;
+
+    char* file = malloc(length + size + 2);
+
+    if (file == NULL) exit(1);
+
+    snprintf(file, length + size + 2, "%s/%s", path, entry->d_name);
+
+    append(paths, file);
+  }
+
+  closedir(directory);
+
+  qsort(paths->content + first, paths->count - first, sizeof(char*), compare);
+}
+
+static bool take(Deque* deque, int* job) {
+  pthread_mutex_lock(&deque->lock);
+
+  bool found = deque->top < deque->bottom;
+
+  if (found == true)
+    *job = --deque->bottom;
+
+  pthread_mutex_unlock(&deque->lock);
+
+  return found;
+}
+
+static bool steal(Deque* deque, int* job) {
+  pthread_mutex_lock(&deque->lock);
+
+  bool found = deque->top < deque->bottom;
+
+  if (found == true)
+    *job = deque->top++;
+
+  pthread_mutex_unlock(&deque->lock);
+
+  return found;
+}
+
+static bool next(Runner* runner, int index, int* job) {
+  if (take(&runner->deques[index], job) == true)
+    return true;
+
+  for (int i = 1; i < runner->workers; i++)
+    if (steal(&runner->deques[(index + i) % runner->workers], job) == true)
+      return true;
+
+  return false;
+}
+
+static void* work(void* argument) {
+  Worker* worker = argument;
+  Runner* runner = worker->runner;
+
+  int index;
+
+  while (next(runner, worker->index, &index) == true) {
+    Job* job = &runner->jobs[index];
+
+    double start = now(CLOCK_MONOTONIC), cpu = now(CLOCK_THREAD_CPUTIME_ID);
+
+    VM vm;
+
+    initialize_VM(&vm, runner->settings);
+
+    job->code = runner->emit == true ? compile_file(&vm, job->path) : run_file(&vm, job->path);
+
+    free_VM(&vm);
+
+    job->time = now(CLOCK_MONOTONIC) - start;
+    job->cpu = now(CLOCK_THREAD_CPUTIME_ID) - cpu;
+  }
+
+  return NULL;
+}
+
+int compile_files(Settings* settings, const char** files, int count) {
+  Paths paths = { NULL, 0, 0 };
+
+  for (int i = 0; i < count; i++)
+    expand(&paths, files[i]);
+
+  int code = 0;
+
+  for (int i = 0; i < paths.count; i++) {
+    VM vm;
+
+    initialize_VM(&vm, settings);
+
+    int result = compile_file(&vm, paths.content[i]);
+
+    free_VM(&vm);
+
+    if (code == 0) code = result;
+
+    free((char*)paths.content[i]);
+  }
+
+  free(paths.content);
+
+  return code;
+}
+
+int run_jobs(Settings* settings, const char** files, int count, int workers, bool emit) {
+  Paths paths = { NULL, 0, 0 };
+
+  for (int i = 0; i < count; i++)
+    expand(&paths, files[i]);
+
+  if (workers > paths.count)
+    workers = paths.count == 0 ? 1 : paths.count;
+
+  Runner runner;
+
+  runner.settings = settings;
+  runner.emit = emit;
+  runner.workers = workers;
+
+  runner.jobs = malloc(sizeof(Job) * (paths.count == 0 ? 1 : paths.count));
+  runner.deques = malloc(sizeof(Deque) * workers);
+
+  if (runner.jobs == NULL || runner.deques == NULL) exit(1);
+
+  for (int i = 0; i < paths.count; i++)
+    runner.jobs[i] = (Job){ paths.content[i], 0, 0, 0 };
+
+  for (int i = 0; i < workers; i++) {
+    Deque* deque = &runner.deques[i];
+
+    pthread_mutex_init(&deque->lock, NULL);
+
+    deque->top = (int)((long)paths.count * i / workers);
+    deque->bottom = (int)((long)paths.count * (i + 1) / workers);
+  }
+
+  pthread_t* threads = malloc(sizeof(pthread_t) * workers);
+  Worker* contexts = malloc(sizeof(Worker) * workers);
+
+  if (threads == NULL || contexts == NULL) exit(1);
+
+  double start = now(CLOCK_MONOTONIC);
+
+  int started = 0;
+
+  for (int i = 0; i < workers; i++) {
+    contexts[i] = (Worker){ &runner, i };
+
+    if (pthread_create(&threads[i], NULL, work, &contexts[i]) != 0) break;
+
+    started++;
+  }
+
+  // A worker whose thread could not be created runs on this thread instead, and steals the shares of the ones after it.
+  if (started < workers)
+    work(&contexts[started]);
+
+  for (int i = 0; i < started; i++)
+    pthread_join(threads[i], NULL);
+
+  double elapsed = now(CLOCK_MONOTONIC) - start, cpu = 0;
+
+  int code = 0, failures = 0;
+
+  for (int i = 0; i < paths.count; i++) {
+    Job* job = &runner.jobs[i];
+
+    fprintf(stderr, "[%s] %s: exit %d in %.3fs\n", job->code == 0 ? "PASS" : "FAIL", job->path, job->code, job->time);
+
+    cpu += job->cpu;
+
+    if (job->code != 0 && failures++ == 0)
+      code = job->code;
+  }
+
+  fprintf(stderr, "%d scripts, %d failed, on %d workers: %.3fs elapsed, %.3fs of CPU time (%.2fx parallelism).\n",
+    paths.count, failures, started < workers ? started + 1 : workers, elapsed, cpu, elapsed > 0 ? cpu / elapsed : 0);
+
+  for (int i = 0; i < workers; i++)
+    pthread_mutex_destroy(&runner.deques[i].lock);
+
+  for (int i = 0; i < paths.count; i++)
+    free((char*)paths.content[i]);
+
+  free(paths.content);
+  free(runner.jobs);
+  free(runner.deques);
+  free(threads);
+  free(contexts);
+
+  return code;
+}
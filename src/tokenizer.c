@@ -3,12 +3,22 @@
 
 #include "tokenizer.h"
 
-void set_tokenizer(Tokenizer* tokenizer, const char* source) {
+void set_tokenizer(Tokenizer* tokenizer, const char* source, size_t length) {
   tokenizer->start = source;
   tokenizer->current = source;
+  tokenizer->end = source + length;
   tokenizer->line = 1;
 }
 
+// The source does not need to be terminated: past its end, every character reads as a terminator.
+static inline char peek(Tokenizer* tokenizer) {
+  return tokenizer->current < tokenizer->end ? *tokenizer->current : NULL_TERMINATOR;
+}
+
+static inline char peek_next(Tokenizer* tokenizer) {
+  return tokenizer->current + 1 < tokenizer->end ? tokenizer->current[1] : NULL_TERMINATOR;
+}
+
 static Token make(Tokenizer* tokenizer, Types type) {
   Token token;
 
@@ -39,9 +49,9 @@ static char advance(Tokenizer* tokenizer) {
 }
 
 static char match(Tokenizer* tokenizer, char expected) {
-  if (*tokenizer->current == NULL_TERMINATOR) return false;
+  if (peek(tokenizer) == NULL_TERMINATOR) return false;
 
-  if (*tokenizer->current != expected) return false;
+  if (peek(tokenizer) != expected) return false;
 
   tokenizer->current++;
 
@@ -50,7 +60,7 @@ static char match(Tokenizer* tokenizer, char expected) {
 
 static void skip_whitespace(Tokenizer* tokenizer) {
   while(true) {
-    char character = *tokenizer->current;
+    char character = peek(tokenizer);
 
     switch(character) {
       case ' ':
@@ -65,25 +75,25 @@ static void skip_whitespace(Tokenizer* tokenizer) {
         break;
 
       case '#':
-        while (*tokenizer->current != '\n' && *tokenizer->current != NULL_TERMINATOR) 
+        while (peek(tokenizer) != '\n' && peek(tokenizer) != NULL_TERMINATOR) 
           advance(tokenizer);
 
         break;
 
       case '/':
-        if (tokenizer->current[1] == '*') {
+        if (peek_next(tokenizer) == '*') {
           advance(tokenizer); advance(tokenizer);
 
           while (true) {
-            if (*tokenizer->current == '*' && tokenizer->current[1] == '/') {
+            if (peek(tokenizer) == '*' && peek_next(tokenizer) == '/') {
               advance(tokenizer); advance(tokenizer);
               break;
             }
             
-            if (*tokenizer->current == NULL_TERMINATOR)
+            if (peek(tokenizer) == NULL_TERMINATOR)
               break;
 
-            if (*tokenizer->current == '\n')
+            if (peek(tokenizer) == '\n')
               tokenizer->line++;
 
             advance(tokenizer);
@@ -187,7 +197,7 @@ static Types trie(Tokenizer* tokenizer) {
 }
 
 static Token identifier(Tokenizer* tokenizer) {
-  while (alpha(*tokenizer->current) || digit(*tokenizer->current))
+  while (alpha(peek(tokenizer)) || digit(peek(tokenizer)))
     advance(tokenizer);
 
   Types type = trie(tokenizer);
@@ -196,13 +206,13 @@ static Token identifier(Tokenizer* tokenizer) {
 } 
 
 static Token number(Tokenizer* tokenizer) {
-  while (digit(*tokenizer->current))
+  while (digit(peek(tokenizer)))
     advance(tokenizer);
 
-  if (*tokenizer->current == '.' && digit(tokenizer->current[1])) {
+  if (peek(tokenizer) == '.' && digit(peek_next(tokenizer))) {
     advance(tokenizer);
 
-    while (digit(*tokenizer->current))
+    while (digit(peek(tokenizer)))
       advance(tokenizer);
   }
 
@@ -210,12 +220,12 @@ static Token number(Tokenizer* tokenizer) {
 }
 
 static Token string(Tokenizer* tokenizer, char quote) {
-  while (*tokenizer->current != quote && *tokenizer->current != NULL_TERMINATOR) {
-    if (*tokenizer->current == '\n') tokenizer->line++;
+  while (peek(tokenizer) != quote && peek(tokenizer) != NULL_TERMINATOR) {
+    if (peek(tokenizer) == '\n') tokenizer->line++;
     advance(tokenizer);
   }
 
-  if (*tokenizer->current == NULL_TERMINATOR) return error(tokenizer, "Unterminated string literal.");
+  if (peek(tokenizer) == NULL_TERMINATOR) return error(tokenizer, "Unterminated string literal.");
 
   advance(tokenizer);
 
@@ -227,7 +237,7 @@ Token scan(Tokenizer* tokenizer) {
 
   tokenizer->start = tokenizer->current;
 
-  if (*tokenizer->current == NULL_TERMINATOR) return make(tokenizer, TOKEN_EOF);
+  if (peek(tokenizer) == NULL_TERMINATOR) return make(tokenizer, TOKEN_EOF);
 
   char character = advance(tokenizer);
     
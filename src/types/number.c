@@ -0,0 +1,237 @@
+#include <stdlib.h>
+#include <errno.h>
+
+#include "vm.h"
+#include "types/number.h"
+#include "types/object.h"
+
+static bool parse_integer(const char* content, Value* result) {
+  char* end = NULL;
+
+  errno = 0;
+
+  long long integer = strtoll(content, &end, 10);
+
+  if (errno == 0 && end != content && *end == NULL_TERMINATOR && FITS_INTEGER(integer)) {
+    *result = INTEGER(integer);
+    return true;
+  }
+
+  return false;
+}
+
+Value parse_number(VM* vm, const char* content) {
+  Value integer;
+
+  if (parse_integer(content, &integer) == true)
+    return integer;
+
+  if (vm->settings.numerics == NUMERICS_FAST)
+    return DOUBLE(strtod(content, NULL));
+
+  mpf_t number;
+
+  mpf_init2(number, vm->settings.precision);
+  mpf_set_str(number, content, 10);
+
+  Value result = normalize_number(vm, number);
+
+  mpf_clear(number);
+
+  return result;
+}
+
+Value intern_number(VM* vm, const char* content, int length) {
+  char string[length + 1];
+
+  memcpy(string, content, length);
+
+  string[length] = NULL_TERMINATOR;
+
+  Value value;
+
+  if (parse_integer(string, &value) == true || vm->settings.numerics == NUMERICS_FAST)
+    return parse_number(vm, string);
+
+  String* key = copy_string(vm, content, length);
+
+  if (table_get(&vm->numbers, key, &value) == true)
+    return value;
+
+  push(&vm->stack, OBJECT(key));
+
+  value = parse_number(vm, string);
+
+  push(&vm->stack, value);
+
+  table_set(&vm->numbers, key, value);
+
+  pop(&vm->stack, 2);
+
+  return value;
+}
+
+Value normalize_number(VM* vm, mpf_t value) {
+  if (mpf_integer_p(value) && mpf_fits_slong_p(value)) {
+    long integer = mpf_get_si(value);
+
+    if (FITS_INTEGER(integer))
+      return INTEGER(integer);
+  }
+
+  return OBJECT(allocate_number_from_gmp(vm, value));
+}
+
+Value normalize_double(double value) {
+  if (value == trunc(value) && value >= -0x1p63 && value < 0x1p63 && FITS_INTEGER((int64_t)value))
+    return INTEGER((int64_t)value);
+
+  return DOUBLE(value);
+}
+
+void to_gmp(Value value, mpf_t result) {
+  if (IS_INTEGER(value))
+    mpf_set_si(result, AS_INTEGER(value));
+  else if (IS_DOUBLE(value))
+    mpf_set_d(result, AS_DOUBLE(value));
+  else mpf_set(result, AS_NUMBER(value)->content);
+}
+
+double to_double(Value value) {
+  if (IS_INTEGER(value)) return (double)AS_INTEGER(value);
+
+  if (IS_DOUBLE(value)) return AS_DOUBLE(value);
+
+  return mpf_get_d(AS_NUMBER(value)->content);
+}
+
+static mpf_srcptr operand(Value value, mpf_t temporary) {
+  if (IS_NUMBER_OBJECT(value)) 
+    return AS_NUMBER(value)->content;
+
+  mpf_init2(temporary, GMP_IMMEDIATE_PRECISION);
+
+  to_gmp(value, temporary);
+
+  return temporary;
+}
+
+// GMP only raises to integral powers: fractional exponents, and zero to a negative power, fall back to pow().
+static bool gmp_power(mpf_t result, mpf_srcptr base, mpf_srcptr exponent) {
+  if (mpf_integer_p(exponent) == 0 || mpf_fits_slong_p(exponent) == 0)
+    return false;
+
+  long power = mpf_get_si(exponent);
+
+  if (power >= 0) {
+    mpf_pow_ui(result, base, (unsigned long)power);
+    return true;
+  }
+
+  if (mpf_sgn(base) == 0) return false;
+
+  mpf_pow_ui(result, base, 0UL - (unsigned long)power);
+  mpf_ui_div(result, 1, result);
+
+  return true;
+}
+
+static Value gmp_arithmetic(VM* vm, Arithmetics operation, Value left, Value right) {
+  mpf_t first, second, result;
+
+  mpf_srcptr a = operand(left, first), b = operand(right, second);
+
+  mpf_init2(result, vm->settings.precision);
+
+  bool exact = true;
+
+  switch (operation) {
+    case ARITHMETIC_ADD: mpf_add(result, a, b); break;
+    case ARITHMETIC_SUBTRACT: mpf_sub(result, a, b); break;
+    case ARITHMETIC_MULTIPLY: mpf_mul(result, a, b); break;
+    case ARITHMETIC_DIVIDE: mpf_div(result, a, b); break;
+    case ARITHMETIC_POWER: exact = gmp_power(result, a, b); break;
+  }
+
+  Value number = exact == true ? normalize_number(vm, result) : normalize_double(double_arithmetic(operation, mpf_get_d(a), mpf_get_d(b)));
+
+  if (a == first) mpf_clear(first); 
+  if (b == second) mpf_clear(second);
+
+  mpf_clear(result);
+
+  return number;
+}
+
+Value arithmetic(VM* vm, Arithmetics operation, Value left, Value right) {
+  if (IS_INTEGER(left) && IS_INTEGER(right)) {
+    int64_t result;
+
+    if (integer_arithmetic(operation, AS_INTEGER(left), AS_INTEGER(right), &result))
+      return INTEGER(result);
+
+    if (vm->settings.numerics == NUMERICS_PRECISE)
+      return gmp_arithmetic(vm, operation, left, right);
+  }
+
+  if (IS_NUMBER_OBJECT(left) || IS_NUMBER_OBJECT(right))
+    return gmp_arithmetic(vm, operation, left, right);
+
+  return DOUBLE(double_arithmetic(operation, to_double(left), to_double(right)));
+}
+
+Value negation(VM* vm, Value value) {
+  if (IS_INTEGER(value) && AS_INTEGER(value) != INTEGER_MIN)
+    return INTEGER(-AS_INTEGER(value));
+
+  if (IS_DOUBLE(value))
+    return DOUBLE(-AS_DOUBLE(value));
+
+  if (IS_INTEGER(value) && vm->settings.numerics == NUMERICS_FAST)
+    return DOUBLE(-(double)AS_INTEGER(value));
+
+  mpf_t result;
+
+  mpf_init2(result, vm->settings.precision);
+
+  to_gmp(value, result);
+
+  mpf_neg(result, result);
+
+  Value number = normalize_number(vm, result);
+
+  mpf_clear(result);
+
+  return number;
+}
+
+static int compare_gmp(Number* number, Value value) {
+  if (IS_INTEGER(value)) return mpf_cmp_si(number->content, AS_INTEGER(value));
+
+  if (IS_DOUBLE(value)) return mpf_cmp_d(number->content, AS_DOUBLE(value));
+
+  return mpf_cmp(number->content, AS_NUMBER(value)->content);
+}
+
+int compare_numbers(Value left, Value right) {
+  if (IS_INTEGER(left) && IS_INTEGER(right))
+    return (AS_INTEGER(left) > AS_INTEGER(right)) - (AS_INTEGER(left) < AS_INTEGER(right));
+
+  if (IS_NUMBER_OBJECT(left)) 
+    return compare_gmp(AS_NUMBER(left), right);
+
+  if (IS_NUMBER_OBJECT(right)) 
+    return -compare_gmp(AS_NUMBER(right), left);
+
+  double first = to_double(left), second = to_double(right);
+
+  return (first > second) - (first < second);
+}
+
+bool zero(Value value) {
+  if (IS_INTEGER(value)) return AS_INTEGER(value) == 0;
+
+  if (IS_DOUBLE(value)) return AS_DOUBLE(value) == 0.0;
+
+  return mpf_sgn(AS_NUMBER(value)->content) == 0;
+}
@@ -1,9 +1,11 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "vm.h"
 #include "types/object.h"
 #include "utilities/memory.h"
+#include "utilities/bytes.h"
 
 #define ALLOCATE_OBJECT(vm, object, type, prototype) \
   (object*)allocate_object(vm, sizeof(object), type, prototype)
@@ -13,6 +15,8 @@ static Object* allocate_object(VM* vm, size_t size, Objects type, Prototype* pro
   object->type = type;
   object->prototype = prototype;
   object->mark = false;
+  object->old = false;
+  object->remembered = false;
 
   object->next = vm->objects;
   vm->objects = object;
@@ -22,34 +26,53 @@ static Object* allocate_object(VM* vm, size_t size, Objects type, Prototype* pro
 
 Number* allocate_number_from_gmp(VM* vm, mpf_t value) {
   Number* number = ALLOCATE_OBJECT(vm, Number, OBJECT_NUMBER, &vm->prototypes.number);
-  mpf_init_set(number->content, value);
+  mpf_init2(number->content, vm->settings.precision);
+  mpf_set(number->content, value);
   return number;
 }
 
 Number* allocate_number_from_double(VM* vm, double value) {
   Number* number = ALLOCATE_OBJECT(vm, Number, OBJECT_NUMBER, &vm->prototypes.number);
-  mpf_init_set_d(number->content, value);
+  mpf_init2(number->content, vm->settings.precision);
+  mpf_set_d(number->content, value);
   return number;
 }
 
 Number* allocate_number_from_string(VM* vm, const char* value) {
   Number* number = ALLOCATE_OBJECT(vm, Number, OBJECT_NUMBER, &vm->prototypes.number);
-  mpf_init_set_str(number->content, value, 10);
+  mpf_init2(number->content, vm->settings.precision);
+  mpf_set_str(number->content, value, 10);
   return number;
 }
 
-String* allocate_string(VM* vm, const char* content, int length, uint32_t hash) {
+String* allocate_string(VM* vm, const char* content, int length) {
   String* string = ALLOCATE_OBJECT(vm, String, OBJECT_STRING, &vm->prototypes.string);
   string->content = (char*)content;
   string->length = length;
 
+  string->hash = 0;
+  string->interned = false;
+
+  return string;
+}
+
+static void enter(VM* vm, String* string, uint32_t hash) {
   string->hash = hash;
+  string->interned = true;
 
   push(&vm->stack, OBJECT(string));
   table_set(&vm->strings, string, UNDEFINED);
   pop(&vm->stack, 1);
+}
 
-  return string;
+// While the incremental collector sweeps, an unmarked intern may be dead and
+// still waiting for its slice to free it: marking it makes the sweep keep it.
+// An intern that was already swept keeps the mark until the next cycle, which
+// only delays freeing it by one collection.
+static String* revive(VM* vm, String* intern) {
+  if (vm->phase == PHASE_SWEEP) intern->object.mark = true;
+
+  return intern;
 }
 
 String* copy_string(VM* vm, const char* content, int length) {
@@ -57,26 +80,183 @@ String* copy_string(VM* vm, const char* content, int length) {
 
   String* intern = table_find_string(&vm->strings, content, length, hash);
 
-  if (intern != NULL) return intern;
+  if (intern != NULL) return revive(vm, intern);
 
   char* heap = ALLOCATE(vm, char, length + 1);
   memcpy(heap, content, length);
   heap[length] = '\0';
 
-  return allocate_string(vm, heap, length, hash);
+  String* string = allocate_string(vm, heap, length);
+
+  enter(vm, string, hash);
+
+  return string;
 }
 
+// Strings built at run time are neither hashed nor interned until they are
+// used as the key of a Table, see intern_string.
 String* take_string(VM* vm, const char* content, int length) {
-  uint32_t hash = hashing(content, length);
+  return allocate_string(vm, content, length);
+}
 
-  String* intern = table_find_string(&vm->strings, content, length, hash);
+String* loose_string(VM* vm, const char* content, int length) {
+  char* heap = ALLOCATE(vm, char, length + 1);
+  memcpy(heap, content, length);
+  heap[length] = '\0';
+
+  return allocate_string(vm, heap, length);
+}
+
+String* intern_string(VM* vm, String* string) {
+  if (string->interned == true) return string;
+
+  uint32_t hash = hashing(string->content, string->length);
+
+  String* intern = table_find_string(&vm->strings, string->content, string->length, hash);
+
+  if (intern != NULL) return revive(vm, intern);
+
+  enter(vm, string, hash);
+
+  return string;
+}
+
+String* concatenate(VM* vm, String* left, String* right) {
+  int length = left->length + right->length;
+
+  char* content = ALLOCATE(vm, char, length + 1);
+
+  memcpy(content, left->content, left->length);
+  memcpy(content + left->length, right->content, right->length);
+
+  content[length] = '\0';
+
+  return take_string(vm, content, length);
+}
+
+static inline Object* settled(Object* object) {
+  if (object->type == OBJECT_ROPE && ((Rope*)object)->flat != NULL)
+    return (Object*)((Rope*)object)->flat;
 
-  if (intern != NULL) {
-    FREE_ARRAY(vm, char, (char*)content, length + 1);
-    return intern;
+  return object;
+}
+
+static inline int measure(Object* object) {
+  return object->type == OBJECT_ROPE ? ((Rope*)object)->length : ((String*)object)->length;
+}
+
+Object* join(VM* vm, Object* left, Object* right) {
+  left = settled(left);
+  right = settled(right);
+
+  if (measure(left) == 0) return right;
+  if (measure(right) == 0) return left;
+
+  int length = measure(left) + measure(right);
+
+  if (length < ROPE_MINIMUM_LENGTH && left->type == OBJECT_STRING && right->type == OBJECT_STRING)
+    return (Object*)concatenate(vm, (String*)left, (String*)right);
+
+  Rope* rope = ALLOCATE_OBJECT(vm, Rope, OBJECT_ROPE, &vm->prototypes.string);
+
+  rope->length = length;
+  rope->left = left;
+  rope->right = right;
+  rope->flat = NULL;
+
+  return (Object*)rope;
+}
+
+// Writes the leaves from the last to the first, so the left spine that
+// repeated appends build never has more than two pending nodes.
+static void gather(Rope* rope, char* content) {
+  int count = 0, capacity = MINIMUM_CAPACITY;
+
+  Object** pending = malloc(sizeof(Object*) * capacity);
+
+  if (pending == NULL) exit(1);
+
+  char* end = content + rope->length;
+
+  pending[count++] = (Object*)rope;
+
+  while (count > 0) {
+    Object* node = settled(pending[--count]);
+
+    if (node->type == OBJECT_STRING) {
+      String* string = (String*)node;
+
+      end -= string->length;
+      memcpy(end, string->content, string->length);
+
+      continue;
+    }
+
+    if (capacity < count + 2) {
+      capacity = GROW_CAPACITY(capacity);
+
+      if ((pending = realloc(pending, sizeof(Object*) * capacity)) == NULL) exit(1);
+    }
+
+    pending[count++] = ((Rope*)node)->left;
+    pending[count++] = ((Rope*)node)->right;
   }
 
-  return allocate_string(vm, content, length, hash);
+  free(pending);
+}
+
+String* flatten(VM* vm, Rope* rope) {
+  if (rope->flat != NULL) return rope->flat;
+
+  push(&vm->stack, OBJECT(rope));
+
+  char* content = ALLOCATE(vm, char, rope->length + 1);
+
+  gather(rope, content);
+
+  content[rope->length] = '\0';
+
+  String* string = take_string(vm, content, rope->length);
+
+  rope->flat = string;
+  rope->left = NULL;
+  rope->right = NULL;
+
+  barrier(vm, (Object*)rope, OBJECT(string));
+
+  pop(&vm->stack, 1);
+
+  return string;
+}
+
+Builder* new_builder(VM* vm) {
+  Builder* builder = ALLOCATE_OBJECT(vm, Builder, OBJECT_BUILDER, &vm->prototypes.builder);
+
+  builder->length = 0;
+  builder->capacity = 0;
+  builder->content = NULL;
+
+  return builder;
+}
+
+void append_builder(VM* vm, Builder* builder, const char* content, int length) {
+  if (builder->capacity < builder->length + length) {
+    int capacity = builder->capacity;
+
+    while (capacity < builder->length + length)
+      capacity = GROW_CAPACITY(capacity);
+
+    push(&vm->stack, OBJECT(builder));
+
+    builder->content = ALLOCATE_ARRAY(vm, char, builder->content, builder->capacity, capacity);
+    builder->capacity = capacity;
+
+    pop(&vm->stack, 1);
+  }
+
+  memcpy(builder->content + builder->length, content, length);
+
+  builder->length += length;
 }
 
 Upvalue* new_upvalue(VM* vm, Value* location) {
@@ -136,24 +316,100 @@ Class* new_class(VM* vm, String* identifier) {
 
   class->identifier = identifier;
 
-  initialize_table(&class->members, vm);
+  initialize_table(&class->layout, vm);
   initialize_table(&class->methods, vm);
 
+  initialize_constants(&class->defaults, vm);
+
+  class->version = 0;
+
+  class->layout.owner = (Object*)class;
+  class->methods.owner = (Object*)class;
+
   return class;
 }
 
 Instance* new_instance(VM* vm, Class* class) {
-  Instance* instance = ALLOCATE_OBJECT(vm, Instance, OBJECT_INSTANCE, &vm->prototypes.object);
+  int count = class->defaults.count;
 
-  instance->class = class;
+  Instance* instance = (Instance*)allocate_object(vm, sizeof(Instance) + sizeof(Value) * count, OBJECT_INSTANCE, &vm->prototypes.object);
 
-  initialize_table(&instance->fields, vm);
+  instance->class = class;
+  instance->dictionary = NULL;
+  instance->count = count;
 
-  table_append(&class->members, &instance->fields);
+  for (int i = 0; i < count; i++)
+    instance->fields[i] = class->defaults.values[i];
 
   return instance;
 }
 
+void define_member(VM* vm, Class* class, String* identifier, Value value) {
+  Value slot;
+
+  if (table_get(&class->layout, identifier, &slot) == true)
+    class->defaults.values[AS_INTEGER(slot)] = value;
+  else {
+    table_set(&class->layout, identifier, INTEGER(class->defaults.count));
+    write_constants(&class->defaults, value);
+  }
+
+  barrier(vm, (Object*)class, value);
+
+  class->version++;
+}
+
+void define_method(VM* vm, Class* class, String* identifier, Value value) {
+  table_set(&class->methods, identifier, value);
+
+  class->version++;
+}
+
+bool instance_get(Instance* instance, String* identifier, Value* value) {
+  if (instance->dictionary != NULL)
+    return table_get(instance->dictionary, identifier, value);
+
+  Value slot;
+
+  if (table_get(&instance->class->layout, identifier, &slot) == false || AS_INTEGER(slot) >= instance->count)
+    return false;
+
+  *value = instance->fields[AS_INTEGER(slot)];
+
+  return true;
+}
+
+bool instance_set(VM* vm, Instance* instance, String* identifier, Value value) {
+  if (instance->dictionary == NULL) {
+    Value slot;
+
+    if (table_get(&instance->class->layout, identifier, &slot) == true && AS_INTEGER(slot) < instance->count) {
+      instance->fields[AS_INTEGER(slot)] = value;
+      barrier(vm, (Object*)instance, value);
+      return false;
+    }
+
+    Table* dictionary = ALLOCATE(vm, Table, 1);
+
+    initialize_table(dictionary, vm);
+
+    dictionary->owner = (Object*)instance;
+
+    Table* layout = &instance->class->layout;
+
+    for (int i = 0; i <= layout->capacity; i++) {
+      Entry* entry = &layout->entries[i];
+
+      if (entry->key != NULL && AS_INTEGER(entry->value) < instance->count)
+        table_set(dictionary, entry->key, instance->fields[AS_INTEGER(entry->value)]);
+    }
+
+    instance->dictionary = dictionary;
+  }
+
+  return table_set(instance->dictionary, identifier, value);
+}
+
 Bound* new_bound(VM* vm, Value receiver, Closure* method) {
   Bound* bound = ALLOCATE_OBJECT(vm, Bound, OBJECT_BOUND, &vm->prototypes.object);
 
@@ -178,6 +434,29 @@ void print_object(Value value) {
 
     case OBJECT_STRING: printf("%s", AS_STRING(value)->content); break;
 
+    case OBJECT_ROPE: {
+      Rope* rope = AS_ROPE(value);
+
+      if (rope->flat != NULL) {
+        printf("%s", rope->flat->content);
+        break;
+      }
+
+      char* content = malloc(rope->length);
+
+      if (content == NULL) exit(1);
+
+      gather(rope, content);
+
+      fwrite(content, 1, rope->length, stdout);
+
+      free(content);
+
+      break;
+    }
+
+    case OBJECT_BUILDER: printf("<StringBuilder>"); break;
+
     case OBJECT_FUNCTION:
     case OBJECT_CLOSURE: {
       Function* function;     
@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
 
 #include "types/value.h"
 #include "types/object.h"
+#include "types/number.h"
 #include "utilities/memory.h"
 
 void initialize_constants(Constants* constants, VM* vm) {
@@ -31,16 +33,43 @@ void write_constants(Constants* constants, Value value) {
   constants->count++;
 }
 
+// Two interned strings are equal only if they are the same object, while a
+// loose one has to be compared by content.
+static inline bool equal_strings(String* left, String* right) {
+  if (left->interned == true && right->interned == true) return false;
+
+  return left->length == right->length && memcmp(left->content, right->content, left->length) == 0;
+}
+
 bool equal(Value left, Value right) {
-  if (left.type != right.type) return false;
+#ifdef NAN_BOXING
+  if (IS_DOUBLE(left) && IS_DOUBLE(right))
+    return AS_DOUBLE(left) == AS_DOUBLE(right);
+
+  if (left == right) return true;
+
+  if (IS_STRING(left) && IS_STRING(right))
+    return equal_strings(AS_STRING(left), AS_STRING(right));
+
+  return IS_NUMBER(left) && IS_NUMBER(right) && compare_numbers(left, right) == 0;
+#else
+  if (left.type != right.type) 
+    return IS_NUMBER(left) && IS_NUMBER(right) && compare_numbers(left, right) == 0;
 
   switch (left.type) {  
     case VALUE_BOOLEAN: return AS_BOOLEAN(left) == AS_BOOLEAN(right);
+
+    case VALUE_INTEGER: return AS_INTEGER(left) == AS_INTEGER(right);
+
+    case VALUE_DOUBLE: return AS_DOUBLE(left) == AS_DOUBLE(right);
     
     case VALUE_OBJECT: {
-      if (OBJECT_TYPE(left) == OBJECT_NUMBER && OBJECT_TYPE(right) == OBJECT_NUMBER)
-        return mpf_cmp(AS_NUMBER(left)->content, AS_NUMBER(right)->content) == 0; 
-      else return AS_OBJECT(left) == AS_OBJECT(right);
+      if (AS_OBJECT(left) == AS_OBJECT(right)) return true;
+
+      if (IS_STRING(left) && IS_STRING(right))
+        return equal_strings(AS_STRING(left), AS_STRING(right));
+
+      return IS_NUMBER_OBJECT(left) && IS_NUMBER_OBJECT(right) && compare_numbers(left, right) == 0;
     }
 
     case VALUE_VOID: return true;
@@ -49,16 +78,64 @@ bool equal(Value left, Value right) {
 
     default: return false;
   }
+#endif
 }
 
-void print_value(Value value) {
-  switch (value.type) {
-    case VALUE_BOOLEAN: printf(AS_BOOLEAN(value) ? "true" : "false"); break;
+bool identical(Value left, Value right) {
+#ifdef NAN_BOXING
+  return left == right;
+#else
+  if (left.type != right.type) return false;
 
-    case VALUE_OBJECT: print_object(value); break;
+  switch (left.type) {
+    case VALUE_BOOLEAN: return AS_BOOLEAN(left) == AS_BOOLEAN(right);
+
+    case VALUE_INTEGER: return AS_INTEGER(left) == AS_INTEGER(right);
 
-    case VALUE_VOID: printf("void"); break;
+    case VALUE_DOUBLE: return memcmp(&left.content.floating, &right.content.floating, sizeof(double)) == 0;
 
-    case VALUE_UNDEFINED: printf("undefined"); break;
+    case VALUE_OBJECT: return AS_OBJECT(left) == AS_OBJECT(right);
+
+    default: return true;
   }
-}
\ No newline at end of file
+#endif
+}
+
+uint32_t hash_value(Value value) {
+  uint64_t bits;
+
+#ifdef NAN_BOXING
+  bits = value;
+#else
+  switch (value.type) {
+    case VALUE_BOOLEAN: bits = AS_BOOLEAN(value); break;
+    case VALUE_INTEGER: bits = (uint64_t)AS_INTEGER(value); break;
+    case VALUE_DOUBLE: memcpy(&bits, &value.content.floating, sizeof(double)); break;
+    case VALUE_OBJECT: bits = (uint64_t)(uintptr_t)AS_OBJECT(value); break;
+
+    default: bits = 0; break;
+  }
+
+  bits ^= (uint64_t)value.type << 56;
+#endif
+
+  bits ^= bits >> 33;
+  bits *= 0xff51afd7ed558ccdULL;
+  bits ^= bits >> 33;
+
+  return (uint32_t)bits;
+}
+
+void print_value(Value value) {
+  if (IS_BOOLEAN(value)) printf(AS_BOOLEAN(value) ? "true" : "false");
+
+  else if (IS_INTEGER(value)) printf("%" PRId64, AS_INTEGER(value));
+
+  else if (IS_DOUBLE(value)) printf("%.14g", AS_DOUBLE(value));
+
+  else if (IS_OBJECT(value)) print_object(value);
+
+  else if (IS_VOID(value)) printf("void");
+
+  else if (IS_UNDEFINED(value)) printf("undefined");
+}
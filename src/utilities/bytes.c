@@ -0,0 +1,265 @@
+#include <string.h>
+
+#include "utilities/bytes.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define BYTES_X86
+
+  #include <immintrin.h>
+#endif
+
+#define PRIME32 0x9E3779B1U
+#define PRIME64 0x9E3779B97F4A7C15ULL
+#define AVALANCHE 0x165667919E3779F9ULL
+
+// Every kernel reads the same secret in the same order, so a string hashes
+// to the same value whichever kernel the CPU ends up running.
+static const uint64_t secret[HASH_SECRET] = {
+  0x2cb0f69f4abea221ULL, 0x9417034723148989ULL, 0xdd555950609dfe03ULL,
+  0xdbafb150deb12800ULL, 0x7e789b2e6c442cb6ULL, 0xf41e5636c7e4f8c4ULL,
+  0x0959d150f8fba7e4ULL, 0xa97316f13cdb9eeaULL, 0x74cd8258f9520068ULL,
+  0x55c74a62e116868bULL, 0xd2f4c799a2023cbdULL, 0xdf98cb79a37b51b9ULL,
+  0x396f5885524f3905ULL, 0xaf1d56386ca3b276ULL, 0xa9ffbe6b5104e85aULL,
+  0x6bd0c51b9fd533b3ULL, 0x980ce91c50ab4b56ULL, 0x28ac395780fe62c5ULL,
+  0x768912e3a6bcedc7ULL, 0x50b3e8c9332c7c88ULL, 0xce3bbfe520bd47daULL,
+  0xcba6c8e8e0bb7c4fULL, 0xbf194db8434a346dULL, 0x7d8f2a7b60416d7fULL
+};
+
+// Stripes that share a block each start one word further into the secret.
+#define BLOCK_STRIPES ( HASH_SECRET - HASH_STRIPE / 8 )
+
+static inline uint64_t read64(const uint8_t* bytes) {
+  uint64_t value;
+  memcpy(&value, bytes, sizeof(uint64_t));
+  return value;
+}
+
+static inline uint64_t read32(const uint8_t* bytes) {
+  uint32_t value;
+  memcpy(&value, bytes, sizeof(uint32_t));
+  return value;
+}
+
+static inline uint64_t mix(uint64_t left, uint64_t right) {
+#ifdef __SIZEOF_INT128__
+  __uint128_t product = (__uint128_t)left * right;
+
+  return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+  uint64_t low = (left & 0xffffffff) * (right & 0xffffffff);
+  uint64_t middle = (left >> 32) * (right & 0xffffffff);
+  uint64_t cross = (left & 0xffffffff) * (right >> 32) + (middle & 0xffffffff) + (low >> 32);
+  uint64_t high = (left >> 32) * (right >> 32) + (middle >> 32) + (cross >> 32);
+
+  return ((cross << 32) | (low & 0xffffffff)) ^ high;
+#endif
+}
+
+static inline uint32_t fold(uint64_t hash) {
+  hash ^= hash >> 37;
+  hash *= AVALANCHE;
+  hash ^= hash >> 32;
+
+  return (uint32_t)hash;
+}
+
+static inline uint64_t hash_short(const uint8_t* bytes, size_t length) {
+  uint64_t left = 0, right = 0;
+
+  if (length >= 4) {
+    size_t step = (length >> 3) << 2;
+
+    left = (read32(bytes) << 32) | read32(bytes + step);
+    right = (read32(bytes + length - 4) << 32) | read32(bytes + length - 4 - step);
+  }
+  else if (length > 0)
+    left = ((uint64_t)bytes[0] << 16) | ((uint64_t)bytes[length >> 1] << 8) | bytes[length - 1];
+
+  return mix(left ^ secret[0], right ^ secret[1] ^ (length * PRIME64));
+}
+
+static inline uint64_t hash_medium(const uint8_t* bytes, size_t length) {
+  uint64_t hash = secret[2] ^ (length * PRIME64);
+
+  for (size_t i = 0; i + HASH_SHORT < length; i += HASH_SHORT)
+    hash = mix(read64(bytes + i) ^ secret[3], read64(bytes + i + 8) ^ hash);
+
+  return mix(read64(bytes + length - 16) ^ secret[4], read64(bytes + length - 8) ^ hash);
+}
+
+static inline uint64_t merge(const uint64_t* accumulators, size_t length) {
+  uint64_t hash = length * PRIME64;
+
+  for (int i = 0; i < 8; i += 2)
+    hash += mix(accumulators[i] ^ secret[i + 5], accumulators[i + 1] ^ secret[i + 6]);
+
+  return hash;
+}
+
+static void stripe_portable(uint64_t* accumulators, const uint8_t* bytes, const uint64_t* key) {
+  for (int i = 0; i < 8; i++) {
+    uint64_t data = read64(bytes + i * 8);
+    uint64_t keyed = data ^ key[i];
+
+    accumulators[i ^ 1] += data;
+    accumulators[i] += (keyed & 0xffffffff) * (keyed >> 32);
+  }
+}
+
+static void scramble_portable(uint64_t* accumulators) {
+  for (int i = 0; i < 8; i++) {
+    uint64_t accumulator = accumulators[i];
+
+    accumulator ^= accumulator >> 47;
+    accumulator ^= secret[BLOCK_STRIPES + i];
+    accumulator *= PRIME32;
+
+    accumulators[i] = accumulator;
+  }
+}
+
+// Long inputs run over stripes of eight 64-bit lanes, scrambled once per
+// block, and then over the last stripe of the input, which may overlap the
+// previous one. Each kernel supplies its own stripe and scramble.
+#define HASH_LONG(name, attributes) \
+  attributes static uint64_t hash_long_##name(const uint8_t* bytes, size_t length) { \
+    uint64_t accumulators[8] = { \
+      PRIME32, PRIME64, secret[0], secret[1], secret[2], secret[3], PRIME64 ^ PRIME32, ~PRIME64 \
+    }; \
+    size_t stripes = (length - 1) / HASH_STRIPE; \
+    for (size_t i = 0; i < stripes; i++) { \
+      stripe_##name(accumulators, bytes + i * HASH_STRIPE, secret + i % BLOCK_STRIPES); \
+      if (i % BLOCK_STRIPES == BLOCK_STRIPES - 1) scramble_##name(accumulators); \
+    } \
+    stripe_##name(accumulators, bytes + length - HASH_STRIPE, secret + BLOCK_STRIPES - 1); \
+    return merge(accumulators, length); \
+  } \
+  \
+  attributes static uint32_t hash_##name(const char* string, int length) { \
+    const uint8_t* bytes = (const uint8_t*)string; \
+    if (length <= HASH_SHORT) return fold(hash_short(bytes, length)); \
+    if (length <= HASH_MEDIUM) return fold(hash_medium(bytes, length)); \
+    return fold(hash_long_##name(bytes, length)); \
+  }
+
+HASH_LONG(portable, )
+
+#ifdef BYTES_X86
+
+__attribute__((target("sse2")))
+static inline void stripe_sse2(uint64_t* accumulators, const uint8_t* bytes, const uint64_t* key) {
+  __m128i* lanes = (__m128i*)accumulators;
+
+  for (int i = 0; i < 4; i++) {
+    __m128i data = _mm_loadu_si128((const __m128i*)bytes + i);
+    __m128i keyed = _mm_xor_si128(data, _mm_loadu_si128((const __m128i*)key + i));
+
+    __m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+    __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+    __m128i lane = _mm_loadu_si128(lanes + i);
+
+    _mm_storeu_si128(lanes + i, _mm_add_epi64(lane, _mm_add_epi64(product, swapped)));
+  }
+}
+
+__attribute__((target("sse2")))
+static inline void scramble_sse2(uint64_t* accumulators) {
+  __m128i* lanes = (__m128i*)accumulators;
+  __m128i prime = _mm_set1_epi32((int)PRIME32);
+
+  for (int i = 0; i < 4; i++) {
+    __m128i lane = _mm_loadu_si128(lanes + i);
+
+    lane = _mm_xor_si128(lane, _mm_srli_epi64(lane, 47));
+    lane = _mm_xor_si128(lane, _mm_loadu_si128((const __m128i*)(secret + BLOCK_STRIPES) + i));
+
+    __m128i low = _mm_mul_epu32(lane, prime);
+    __m128i high = _mm_mul_epu32(_mm_srli_epi64(lane, 32), prime);
+
+    _mm_storeu_si128(lanes + i, _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+  }
+}
+
+HASH_LONG(sse2, __attribute__((target("sse2"))))
+
+__attribute__((target("avx2")))
+static inline void stripe_avx2(uint64_t* accumulators, const uint8_t* bytes, const uint64_t* key) {
+  __m256i* lanes = (__m256i*)accumulators;
+
+  for (int i = 0; i < 2; i++) {
+    __m256i data = _mm256_loadu_si256((const __m256i*)bytes + i);
+    __m256i keyed = _mm256_xor_si256(data, _mm256_loadu_si256((const __m256i*)key + i));
+
+    __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+    __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+    __m256i lane = _mm256_loadu_si256(lanes + i);
+
+    _mm256_storeu_si256(lanes + i, _mm256_add_epi64(lane, _mm256_add_epi64(product, swapped)));
+  }
+}
+
+__attribute__((target("avx2")))
+static inline void scramble_avx2(uint64_t* accumulators) {
+  __m256i* lanes = (__m256i*)accumulators;
+  __m256i prime = _mm256_set1_epi32((int)PRIME32);
+
+  for (int i = 0; i < 2; i++) {
+    __m256i lane = _mm256_loadu_si256(lanes + i);
+
+    lane = _mm256_xor_si256(lane, _mm256_srli_epi64(lane, 47));
+    lane = _mm256_xor_si256(lane, _mm256_loadu_si256((const __m256i*)(secret + BLOCK_STRIPES) + i));
+
+    __m256i low = _mm256_mul_epu32(lane, prime);
+    __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(lane, 32), prime);
+
+    _mm256_storeu_si256(lanes + i, _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+  }
+}
+
+HASH_LONG(avx2, __attribute__((target("avx2"))))
+
+#endif
+
+static Kernel available[] = {
+  { "portable", hash_portable },
+#ifdef BYTES_X86
+  { "sse2", hash_sse2 },
+  { "avx2", hash_avx2 },
+#endif
+};
+
+static int supported = 1;
+
+static const Kernel* selected = &available[0];
+
+// Runs before main, and before any thread can hash, so the choice never
+// races with a reader.
+__attribute__((constructor))
+static void detect() {
+#ifdef BYTES_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("sse2")) supported = 2;
+  if (__builtin_cpu_supports("avx2")) supported = 3;
+#endif
+
+  selected = &available[supported - 1];
+}
+
+const Kernel* kernels(int* count) {
+  *count = supported;
+
+  return available;
+}
+
+const Kernel* kernel() {
+  return selected;
+}
+
+uint32_t hashing(const char* string, int length) {
+  if (length <= HASH_SHORT) return fold(hash_short((const uint8_t*)string, length));
+
+  return selected->hash(string, length);
+}
\ No newline at end of file
@@ -0,0 +1,644 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "utilities/cache.h"
+#include "utilities/memory.h"
+#include "utilities/bytes.h"
+#include "utilities/table.h"
+#include "types/number.h"
+
+#define ALIGNMENT 8
+
+#define COMPACT_LIMBS 8
+
+typedef struct {
+  int count;
+  int capacity;
+  uint8_t* content;
+} Buffer;
+
+typedef struct {
+  Object* number;
+  String* literal;
+} Literal;
+
+typedef struct {
+  Buffer buffer;
+
+  Literal* literals;
+  int count;
+} Writer;
+
+typedef struct {
+  const uint8_t* content;
+  size_t size, offset;
+
+  bool error;
+} Reader;
+
+static void write_bytes(Buffer* buffer, const void* bytes, size_t size) {
+  if (buffer->capacity < buffer->count + (int)size) {
+    while (buffer->capacity < buffer->count + (int)size)
+      buffer->capacity = GROW_CAPACITY(buffer->capacity);
+
+    uint8_t* content = realloc(buffer->content, buffer->capacity);
+
+    if (content == NULL) exit(1);
+
+    buffer->content = content;
+  }
+
+  memcpy(buffer->content + buffer->count, bytes, size);
+
+  buffer->count += (int)size;
+}
+
+static void write_integer(Buffer* buffer, int32_t integer) {
+  write_bytes(buffer, &integer, sizeof(int32_t));
+}
+
+static void write_text(Buffer* buffer, const char* content, int length) {
+  write_integer(buffer, length);
+
+  if (length > 0)
+    write_bytes(buffer, content, length);
+}
+
+static void align(Buffer* buffer) {
+  static const uint8_t padding[ALIGNMENT] = { 0 };
+
+  if (buffer->count % ALIGNMENT != 0)
+    write_bytes(buffer, padding, ALIGNMENT - buffer->count % ALIGNMENT);
+}
+
+static int compare_literals(const void* left, const void* right) {
+  uintptr_t a = (uintptr_t)((const Literal*)left)->number, b = (uintptr_t)((const Literal*)right)->number;
+
+  return (a > b) - (a < b);
+}
+
+// Every Number that comes from a literal is interned in vm->numbers, keyed by its text: for
+// Numbers with more than a few limbs, writing that text is far smaller than writing the limbs.
+static void collect_literals(VM* vm, Writer* writer) {
+  Table* numbers = &vm->numbers;
+
+  writer->literals = malloc(sizeof(Literal) * (numbers->count + 1));
+
+  if (writer->literals == NULL) exit(1);
+  writer->count = 0;
+
+  for (int i = 0; i <= numbers->capacity && numbers->count > 0; i++) {
+    Entry* entry = &numbers->entries[i];
+
+    if (entry->key != NULL && IS_OBJECT(entry->value))
+      writer->literals[writer->count++] = (Literal){ AS_OBJECT(entry->value), entry->key };
+  }
+
+  qsort(writer->literals, writer->count, sizeof(Literal), compare_literals);
+}
+
+static bool write_function(Writer* writer, Function* function);
+
+static bool write_value(Writer* writer, Value value) {
+  Buffer* buffer = &writer->buffer;
+
+  uint8_t kind;
+
+  if (IS_INTEGER(value)) {
+    int64_t integer = AS_INTEGER(value);
+
+    kind = CONSTANT_INTEGER;
+    write_bytes(buffer, &kind, 1);
+    write_bytes(buffer, &integer, sizeof(int64_t));
+  }
+  else if (IS_DOUBLE(value)) {
+    double floating = AS_DOUBLE(value);
+
+    kind = CONSTANT_DOUBLE;
+    write_bytes(buffer, &kind, 1);
+    write_bytes(buffer, &floating, sizeof(double));
+  }
+  else if (IS_BOOLEAN(value)) {
+    kind = CONSTANT_BOOLEAN;
+    write_bytes(buffer, &kind, 1);
+
+    uint8_t boolean = AS_BOOLEAN(value);
+    write_bytes(buffer, &boolean, 1);
+  }
+  else if (IS_VOID(value)) {
+    kind = CONSTANT_VOID;
+    write_bytes(buffer, &kind, 1);
+  }
+  else if (IS_UNDEFINED(value)) {
+    kind = CONSTANT_UNDEFINED;
+    write_bytes(buffer, &kind, 1);
+  }
+  else if (IS_STRING(value)) {
+    kind = CONSTANT_STRING;
+    write_bytes(buffer, &kind, 1);
+    write_text(buffer, AS_STRING(value)->content, AS_STRING(value)->length);
+  }
+  else if (IS_NUMBER_OBJECT(value)) {
+    Literal key = { AS_OBJECT(value), NULL };
+
+    Literal* literal = bsearch(&key, writer->literals, writer->count, sizeof(Literal), compare_literals);
+
+    if (literal != NULL && abs(AS_NUMBER(value)->content->_mp_size) > COMPACT_LIMBS) {
+      kind = CONSTANT_LITERAL;
+      write_bytes(buffer, &kind, 1);
+      write_text(buffer, literal->literal->content, literal->literal->length);
+
+      return true;
+    }
+
+    kind = CONSTANT_NUMBER;
+    write_bytes(buffer, &kind, 1);
+
+    mpf_srcptr number = AS_NUMBER(value)->content;
+
+    int64_t exponent = number->_mp_exp;
+
+    write_integer(buffer, number->_mp_size);
+    write_bytes(buffer, &exponent, sizeof(int64_t));
+    write_bytes(buffer, number->_mp_d, sizeof(mp_limb_t) * abs(number->_mp_size));
+  }
+  else if (IS_FUNCTION(value)) {
+    kind = CONSTANT_FUNCTION;
+    write_bytes(buffer, &kind, 1);
+
+    return write_function(writer, AS_FUNCTION(value));
+  }
+  else return false;
+
+  return true;
+}
+
+static bool write_function(Writer* writer, Function* function) {
+  Buffer* buffer = &writer->buffer;
+
+  Chunk* chunk = &function->chunk;
+
+  if (function->identifier != NULL)
+    write_text(buffer, function->identifier->content, function->identifier->length);
+  else write_integer(buffer, -1);
+
+  write_integer(buffer, function->arity);
+  write_integer(buffer, function->count);
+  write_integer(buffer, chunk->caches.count);
+  write_integer(buffer, chunk->count);
+
+  align(buffer);
+  write_bytes(buffer, chunk->code, chunk->count);
+
+  align(buffer);
+  write_bytes(buffer, chunk->lines, sizeof(int) * chunk->count);
+
+  write_integer(buffer, chunk->constants.count);
+
+  for (int i = 0; i < chunk->constants.count; i++)
+    if (write_value(writer, chunk->constants.values[i]) == false)
+      return false;
+
+  return true;
+}
+
+static const void* read_bytes(Reader* reader, size_t size) {
+  if (reader->error == true || reader->size - reader->offset < size) {
+    reader->error = true;
+    return NULL;
+  }
+
+  const void* bytes = reader->content + reader->offset;
+
+  reader->offset += size;
+
+  return bytes;
+}
+
+static int32_t read_integer(Reader* reader) {
+  int32_t integer = 0;
+
+  const void* bytes = read_bytes(reader, sizeof(int32_t));
+
+  if (bytes != NULL)
+    memcpy(&integer, bytes, sizeof(int32_t));
+
+  return integer;
+}
+
+static void skip_padding(Reader* reader) {
+  if (reader->offset % ALIGNMENT != 0)
+    read_bytes(reader, ALIGNMENT - reader->offset % ALIGNMENT);
+}
+
+static Function* read_function(VM* vm, Reader* reader);
+
+static Value read_value(VM* vm, Reader* reader) {
+  const uint8_t* kind = read_bytes(reader, 1);
+
+  if (kind == NULL) return UNDEFINED;
+
+  switch (*kind) {
+    case CONSTANT_INTEGER: {
+      int64_t integer = 0;
+
+      const void* bytes = read_bytes(reader, sizeof(int64_t));
+
+      if (bytes != NULL) memcpy(&integer, bytes, sizeof(int64_t));
+
+      // A cache written by a build with wider immediate integers is
+      // rejected, and its script compiled again.
+      if (FITS_INTEGER(integer) == false) {
+        reader->error = true;
+        return UNDEFINED;
+      }
+
+      return INTEGER(integer);
+    }
+
+    case CONSTANT_DOUBLE: {
+      double floating = 0;
+
+      const void* bytes = read_bytes(reader, sizeof(double));
+
+      if (bytes != NULL) memcpy(&floating, bytes, sizeof(double));
+
+      return DOUBLE(floating);
+    }
+
+    case CONSTANT_BOOLEAN: {
+      const uint8_t* boolean = read_bytes(reader, 1);
+
+      return BOOLEAN(boolean != NULL && *boolean != 0);
+    }
+
+    case CONSTANT_VOID: return VOID;
+
+    case CONSTANT_UNDEFINED: return UNDEFINED;
+
+    case CONSTANT_STRING: {
+      int length = read_integer(reader);
+
+      const char* content = length >= 0 ? read_bytes(reader, length) : NULL;
+
+      if (content == NULL) {
+        reader->error = true;
+        return UNDEFINED;
+      }
+
+      return OBJECT(copy_string(vm, content, length));
+    }
+
+    case CONSTANT_NUMBER: {
+      int size = read_integer(reader);
+
+      int64_t exponent = 0;
+
+      const void* bytes = read_bytes(reader, sizeof(int64_t));
+
+      if (bytes != NULL) memcpy(&exponent, bytes, sizeof(int64_t));
+
+      mpf_t number;
+
+      mpf_init2(number, vm->settings.precision);
+
+      // The limbs are copied as they are, so the Number is exactly the one that was compiled.
+      const void* limbs = abs(size) <= number->_mp_prec + 1 ? read_bytes(reader, sizeof(mp_limb_t) * abs(size)) : NULL;
+
+      if (limbs == NULL) {
+        mpf_clear(number);
+
+        reader->error = true;
+        return UNDEFINED;
+      }
+
+      memcpy(number->_mp_d, limbs, sizeof(mp_limb_t) * abs(size));
+
+      number->_mp_size = size;
+      number->_mp_exp = exponent;
+
+      Value value = OBJECT(allocate_number_from_gmp(vm, number));
+
+      mpf_clear(number);
+
+      return value;
+    }
+
+    case CONSTANT_LITERAL: {
+      int length = read_integer(reader);
+
+      const char* content = length > 0 ? read_bytes(reader, length) : NULL;
+
+      if (content == NULL) {
+        reader->error = true;
+        return UNDEFINED;
+      }
+
+      return intern_number(vm, content, length);
+    }
+
+    case CONSTANT_FUNCTION: {
+      Function* function = read_function(vm, reader);
+
+      if (function == NULL) return UNDEFINED;
+
+      return OBJECT(function);
+    }
+  }
+
+  reader->error = true;
+
+  return UNDEFINED;
+}
+
+static Function* read_function(VM* vm, Reader* reader) {
+  Function* function = new_function(vm);
+
+  push(&vm->stack, OBJECT(function));
+
+  Chunk* chunk = &function->chunk;
+
+  int length = read_integer(reader);
+
+  if (length >= 0) {
+    const char* identifier = read_bytes(reader, length);
+
+    if (identifier != NULL) {
+      function->identifier = copy_string(vm, identifier, length);
+      barrier(vm, (Object*)function, OBJECT(function->identifier));
+    }
+  }
+
+  function->arity = read_integer(reader);
+  function->count = read_integer(reader);
+
+  int caches = read_integer(reader);
+  int count = read_integer(reader);
+
+  if (caches < 0 || count < 0) reader->error = true;
+
+  for (int i = 0; i < caches && reader->error == false; i++)
+    add_cache(chunk);
+
+  skip_padding(reader);
+  const uint8_t* code = read_bytes(reader, count);
+
+  skip_padding(reader);
+  const int* lines = read_bytes(reader, sizeof(int) * count);
+
+  // The chunk borrows its code and lines from the mapping: with no capacity, free_chunk() leaves them alone.
+  if (reader->error == false) {
+    chunk->code = (uint8_t*)code;
+    chunk->lines = (int*)lines;
+    chunk->count = count;
+  }
+
+  int constants = read_integer(reader);
+
+  for (int i = 0; i < constants && reader->error == false; i++) {
+    Value value = read_value(vm, reader);
+
+    if (reader->error == true) break;
+
+    add_constant(chunk, value);
+    barrier(vm, (Object*)function, value);
+  }
+
+  pop(&vm->stack, 1);
+
+  return reader->error == false ? function : NULL;
+}
+
+char* cache_path(const char* path) {
+  size_t length = strlen(path), extension = strlen(SOURCE_EXTENSION);
+
+  if (length > extension && strcmp(path + length - extension, SOURCE_EXTENSION) == 0)
+    length -= extension;
+
+  char* cache = malloc(length + strlen(CACHE_EXTENSION) + 1);
+
+  if (cache == NULL) exit(1);
+
+  memcpy(cache, path, length);
+  strcpy(cache + length, CACHE_EXTENSION);
+
+  return cache;
+}
+
+char* source_path(const char* path) {
+  size_t length = strlen(path), extension = strlen(CACHE_EXTENSION);
+
+  if (length <= extension || strcmp(path + length - extension, CACHE_EXTENSION) != 0)
+    return NULL;
+
+  length -= extension;
+
+  char* source = malloc(length + strlen(SOURCE_EXTENSION) + 1);
+
+  if (source == NULL) exit(1);
+
+  memcpy(source, path, length);
+  strcpy(source + length, SOURCE_EXTENSION);
+
+  return source;
+}
+
+static void set_header(VM* vm, Header* header) {
+  memset(header, 0, sizeof(Header));
+
+  memcpy(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+
+  header->version = CACHE_VERSION;
+
+  header->operations = OP_EXIT + 1;
+  header->value = sizeof(Value);
+  header->limb = sizeof(mp_limb_t);
+
+  header->tier = vm->settings.tier;
+  header->numerics = vm->settings.numerics;
+  header->precision = vm->settings.precision;
+}
+
+bool write_cache(VM* vm, Function* function, const char* path, const char* source, size_t length) {
+  struct stat status;
+
+  if (stat(path, &status) != 0) return false;
+
+  Header header;
+
+  set_header(vm, &header);
+
+  header.seconds = status.st_mtim.tv_sec;
+  header.nanoseconds = status.st_mtim.tv_nsec;
+  header.size = status.st_size;
+  header.hash = hashing(source, (int)length);
+
+  header.globals = vm->globals.count;
+
+  Writer writer = { { 0, 0, NULL }, NULL, 0 };
+
+  Buffer* buffer = &writer.buffer;
+
+  write_bytes(buffer, &header, sizeof(Header));
+
+  for (int i = 0; i < vm->globals.count; i++)
+    write_text(buffer, vm->globals.identifiers[i]->content, vm->globals.identifiers[i]->length);
+
+  collect_literals(vm, &writer);
+
+  bool written = write_function(&writer, function);
+
+  free(writer.literals);
+
+  char* cache = cache_path(path);
+  char temporary[strlen(cache) + 8];
+
+  snprintf(temporary, sizeof(temporary), "%sXXXXXX", cache);
+
+  int descriptor = written == true ? mkstemp(temporary) : -1;
+
+  FILE* file = descriptor >= 0 ? fdopen(descriptor, "wb") : NULL;
+
+  if (file != NULL) {
+    fchmod(descriptor, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+    written = fwrite(buffer->content, 1, buffer->count, file) == (size_t)buffer->count;
+
+    written = fclose(file) == 0 && written == true;
+
+    if (written == true)
+      written = rename(temporary, cache) == 0;
+
+    if (written == false)
+      remove(temporary);
+  }
+  else written = false;
+
+  free(cache);
+  free(buffer->content);
+
+  return written;
+}
+
+static bool fresh(Header* header, const char* path) {
+  struct stat status;
+
+  if (stat(path, &status) != 0) return false;
+
+  if (header->size != (uint64_t)status.st_size) return false;
+
+  if (header->seconds == status.st_mtim.tv_sec && header->nanoseconds == status.st_mtim.tv_nsec)
+    return true;
+
+  int code = 0;
+
+  size_t size;
+
+  const char* source = map_file(path, &size, &code);
+
+  if (source == NULL) return false;
+
+  bool same = hashing(source, (int)size) == header->hash;
+
+  unmap_file(source, size);
+
+  return same;
+}
+
+static void add_mapping(VM* vm, void* address, size_t size) {
+  Mappings* mappings = &vm->mappings;
+
+  if (mappings->capacity < mappings->count + 1) {
+    mappings->capacity = GROW_CAPACITY(mappings->capacity);
+
+    Mapping* content = realloc(mappings->content, sizeof(Mapping) * mappings->capacity);
+
+    if (content == NULL) exit(1);
+
+    mappings->content = content;
+  }
+
+  mappings->content[mappings->count++] = (Mapping){ address, size };
+}
+
+void free_mappings(VM* vm) {
+  for (int i = 0; i < vm->mappings.count; i++)
+    munmap(vm->mappings.content[i].address, vm->mappings.content[i].size);
+
+  free(vm->mappings.content);
+}
+
+Function* load_cache(VM* vm, const char* path) {
+  char* source = source_path(path);
+  char* cache = source == NULL ? cache_path(path) : NULL;
+
+  FILE* file = fopen(source == NULL ? cache : path, "rb");
+
+  struct stat status;
+
+  if (file == NULL || fstat(fileno(file), &status) != 0 || (size_t)status.st_size < sizeof(Header)) {
+    if (file != NULL) fclose(file);
+
+    free(source);
+    free(cache);
+
+    return NULL;
+  }
+
+  void* address = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+
+  fclose(file);
+
+  if (address == MAP_FAILED) {
+    free(source);
+    free(cache);
+
+    return NULL;
+  }
+
+  Header header, expected;
+
+  memcpy(&header, address, sizeof(Header));
+
+  set_header(vm, &expected);
+
+  bool valid = memcmp(&header, &expected, offsetof(Header, seconds)) == 0;
+
+  struct stat original;
+
+  // Without the source next to it, a cache that was run directly is taken as it is.
+  if (valid == true) {
+    if (source == NULL)
+      valid = fresh(&header, path);
+    else if (stat(source, &original) == 0)
+      valid = fresh(&header, source);
+  }
+
+  free(source);
+  free(cache);
+
+  Reader reader = { address, status.st_size, sizeof(Header), !valid };
+
+  for (uint32_t i = 0; i < header.globals && reader.error == false; i++) {
+    int length = read_integer(&reader);
+
+    const char* identifier = length >= 0 ? read_bytes(&reader, length) : NULL;
+
+    if (identifier == NULL || global_slot(vm, copy_string(vm, identifier, length)) != (int)i)
+      reader.error = true;
+  }
+
+  Function* function = reader.error == false ? read_function(vm, &reader) : NULL;
+
+  if (function == NULL) {
+    munmap(address, status.st_size);
+    return NULL;
+  }
+
+  add_mapping(vm, address, status.st_size);
+
+  return function;
+}
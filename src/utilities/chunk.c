@@ -12,6 +12,14 @@ void initialize_chunk(Chunk* chunk, VM* vm) {
   chunk->code = NULL;
 
   chunk->lines = NULL;
+
+  chunk->indexes.count = 0;
+  chunk->indexes.capacity = 0;
+  chunk->indexes.content = NULL;
+
+  chunk->caches.count = 0;
+  chunk->caches.capacity = 0;
+  chunk->caches.content = NULL;
 }
 
 void free_chunk(Chunk* chunk) {
@@ -19,6 +27,10 @@ void free_chunk(Chunk* chunk) {
 
   FREE_ARRAY(chunk->constants.vm, int, chunk->lines, chunk->capacity);
   FREE_ARRAY(chunk->constants.vm, uint8_t, chunk->code, chunk->capacity);
+
+  FREE_ARRAY(chunk->constants.vm, int, chunk->indexes.content, chunk->indexes.capacity);
+
+  FREE_ARRAY(chunk->constants.vm, Cache, chunk->caches.content, chunk->caches.capacity);
 }
 
 void write_chunk(Chunk* chunk, uint8_t byte, int line) {
@@ -43,4 +55,81 @@ int add_constant(Chunk* chunk, Value value) {
   pop(&chunk->constants.vm->stack, 1);
 
   return chunk->constants.count - 1;
-}
\ No newline at end of file
+}
+
+static int* find_index(Indexes* indexes, Constants* constants, Value value) {
+  uint32_t index = hash_value(value) & (indexes->capacity - 1);
+
+  while (true) {
+    int* slot = &indexes->content[index];
+
+    if (*slot == 0 || identical(constants->values[*slot - 1], value))
+      return slot;
+
+    index = (index + 1) & (indexes->capacity - 1);
+  }
+}
+
+static void grow_indexes(Chunk* chunk) {
+  Indexes* indexes = &chunk->indexes;
+
+  int capacity = indexes->capacity;
+
+  int* content = ALLOCATE_ARRAY(chunk->constants.vm, int, NULL, 0, GROW_CAPACITY(capacity));
+
+  int* previous = indexes->content;
+
+  indexes->content = content;
+  indexes->capacity = GROW_CAPACITY(capacity);
+
+  for (int i = 0; i < indexes->capacity; i++)
+    content[i] = 0;
+
+  for (int i = 0; i < capacity; i++)
+    if (previous[i] != 0)
+      *find_index(indexes, &chunk->constants, chunk->constants.values[previous[i] - 1]) = previous[i];
+
+  FREE_ARRAY(chunk->constants.vm, int, previous, capacity);
+}
+
+int intern_constant(Chunk* chunk, Value value) {
+  Indexes* indexes = &chunk->indexes;
+
+  if (indexes->count + 1 > indexes->capacity * MAX_LOAD) {
+    push(&chunk->constants.vm->stack, value);
+    grow_indexes(chunk);
+    pop(&chunk->constants.vm->stack, 1);
+  }
+
+  int* slot = find_index(indexes, &chunk->constants, value);
+
+  if (*slot != 0)
+    return *slot - 1;
+
+  int constant = add_constant(chunk, value);
+
+  *find_index(indexes, &chunk->constants, value) = constant + 1;
+
+  indexes->count++;
+
+  return constant;
+}
+
+int add_cache(Chunk* chunk) {
+  Caches* caches = &chunk->caches;
+
+  if (caches->capacity < caches->count + 1) {
+    int capacity = caches->capacity;
+
+    caches->capacity = GROW_CAPACITY(capacity);
+
+    caches->content = ALLOCATE_ARRAY(chunk->constants.vm, Cache, caches->content, capacity, caches->capacity);
+  }
+
+  Cache* cache = &caches->content[caches->count];
+
+  cache->count = 0;
+  cache->megamorphic = false;
+
+  return caches->count++;
+}
@@ -1,4 +1,7 @@
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
 
 #include "vm.h"
 #include "compiler.h"
@@ -7,23 +10,111 @@
 void* reallocate(VM* vm, void* pointer, size_t oldest, size_t newest) {
   vm->allocate += newest - oldest;
 
-  if (newest > oldest)
-    if (vm->allocate > vm->threshold)
-      recycle(vm);
+  if (newest > oldest) {
+    vm->young += newest - oldest;
 
-  if (newest == 0) {
-    free(pointer);
-    return NULL;
+    if (vm->settings.collector == COLLECTOR_INCREMENTAL) {
+      if (vm->phase != PHASE_IDLE) {
+        if (vm->young > SLICE_SIZE && vm->parser == NULL)
+          recycle_slice(vm);
+      }
+      else if (vm->allocate > vm->threshold) {
+        if (vm->parser == NULL)
+          recycle_slice(vm);
+        else recycle(vm);
+      }
+    }
+    else if (vm->young > NURSERY_SIZE) {
+      if (vm->parser == NULL)
+        recycle_nursery(vm);
+      else if (vm->allocate > vm->threshold)
+        recycle(vm);
+    }
   }
 
-  void* result = realloc(pointer, newest);
+  if (oldest > POOL_MAXIMUM_SIZE && newest > POOL_MAXIMUM_SIZE) {
+    void* result = realloc(pointer, newest);
+
+    if (result == NULL) exit(1);
+
+    return result;
+  }
 
-  if (result == NULL) exit(1);
+  if (newest != 0 && POOL_CLASS(oldest) == POOL_CLASS(newest) && oldest != 0)
+    return pointer;
+
+  void* result = NULL;
+
+  if (newest != 0) {
+    if (newest <= POOL_MAXIMUM_SIZE)
+      result = pool_allocate(&vm->pool, newest);
+    else if ((result = malloc(newest)) == NULL)
+      exit(1);
+
+    if (oldest != 0)
+      memcpy(result, pointer, oldest < newest ? oldest : newest);
+  }
+
+  if (oldest != 0) {
+    if (oldest <= POOL_MAXIMUM_SIZE)
+      pool_release(&vm->pool, pointer, oldest);
+    else free(pointer);
+  }
 
   return result;
 }
 
+static double now() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static void record(VM* vm, double start) {
+  Statistics* statistics = &vm->statistics;
+
+  double pause = now() - start;
+
+  statistics->pause = pause;
+  statistics->total += pause;
+
+  if (pause > statistics->longest)
+    statistics->longest = pause;
+
+  double microseconds = pause * 1e6;
+
+  int bucket = microseconds < 1.0 ? 0 : (int)(4.0 * log2(microseconds));
+
+  if (bucket >= PAUSE_BUCKETS) bucket = PAUSE_BUCKETS - 1;
+
+  statistics->pauses[bucket]++;
+}
+
+double percentile(Statistics* statistics, double fraction) {
+  int count = 0;
+
+  for (int i = 0; i < PAUSE_BUCKETS; i++)
+    count += statistics->pauses[i];
+
+  if (count == 0) return 0.0;
+
+  int seen = 0;
+
+  for (int i = 0; i < PAUSE_BUCKETS; i++) {
+    seen += statistics->pauses[i];
+
+    if (seen >= fraction * count)
+      return exp2((i + 1) / 4.0) / 1e6;
+  }
+
+  return statistics->longest;
+}
+
 void recycle(VM* vm) {
+  double start = now();
+
   Parents parents;
 
   parents.count = 0;
@@ -31,6 +122,8 @@ void recycle(VM* vm) {
   
   parents.content = NULL;
 
+  parents.young = false;
+
   roots(vm, &parents);
   traverse(vm, &parents);
 
@@ -38,7 +131,128 @@ void recycle(VM* vm) {
 
   vm->threshold = vm->allocate * GARBAGE_COLLECTOR_GROW_FACTOR;
 
+  vm->young = 0;
+
+  vm->statistics.majors++;
+
+  free(parents.content);
+
+  record(vm, start);
+}
+
+void recycle_nursery(VM* vm) {
+  double start = now();
+
+  Parents parents;
+
+  parents.count = 0;
+  parents.capacity = 0;
+  
+  parents.content = NULL;
+
+  parents.young = true;
+
+  roots(vm, &parents);
+
+  for (int i = 0; i < vm->remembered.count; i++)
+    gray(&parents, vm->remembered.content[i]);
+
+  traverse(vm, &parents);
+
+  sweep_nursery(vm);
+
+  vm->young = 0;
+
+  vm->statistics.minors++;
+
   free(parents.content);
+
+  record(vm, start);
+
+  if (vm->allocate > vm->threshold)
+    recycle(vm);
+}
+
+static void blacken(Parents* parents, Object* object);
+
+void recycle_slice(VM* vm) {
+  double start = now();
+
+  vm->young = 0;
+
+  if (vm->phase == PHASE_IDLE) {
+    roots(vm, &vm->gray);
+    vm->phase = PHASE_MARK;
+  }
+
+  int budget = SLICE_BUDGET;
+
+  if (vm->phase == PHASE_MARK) {
+    while (budget > 0 && vm->gray.count > 0) {
+      blacken(&vm->gray, vm->gray.content[--vm->gray.count]);
+      budget--;
+    }
+
+    if (vm->gray.count == 0) {
+      roots(vm, &vm->gray);
+      traverse(vm, &vm->gray);
+
+      vm->sweeping = vm->objects;
+      vm->objects = NULL;
+
+      vm->phase = PHASE_SWEEP;
+    }
+  }
+  else {
+    while (budget > 0 && vm->sweeping != NULL) {
+      Object* object = vm->sweeping;
+
+      vm->sweeping = object->next;
+
+      if (object->mark) {
+        object->mark = false;
+
+        if (vm->survivors == NULL) vm->last = object;
+
+        object->next = vm->survivors;
+        vm->survivors = object;
+      }
+      else {
+        free_object(vm, object);
+        vm->statistics.freed++;
+      }
+
+      budget--;
+    }
+
+    if (vm->sweeping == NULL) {
+      if (vm->survivors != NULL) {
+        vm->last->next = vm->objects;
+        vm->objects = vm->survivors;
+      }
+
+      vm->survivors = NULL;
+      vm->last = NULL;
+
+      vm->threshold = vm->allocate * GARBAGE_COLLECTOR_GROW_FACTOR;
+
+      vm->statistics.majors++;
+
+      vm->phase = PHASE_IDLE;
+    }
+  }
+
+  vm->statistics.slices++;
+
+  record(vm, start);
+}
+
+static void mark_table(Parents* parents, Table* table) {
+  for (int i = 0; i <= table->capacity; i++) {
+    Entry* entry = &table->entries[i];
+    mark(parents, OBJECT(entry->key));
+    mark(parents, entry->value);
+  }
 }
 
 void roots(VM* vm, Parents* parents) {
@@ -51,123 +265,148 @@ void roots(VM* vm, Parents* parents) {
   for (int i = 0; i < vm->call.count; i++)
     mark(parents, OBJECT(vm->call.frames[i].closure));
 
-  Table* table = &vm->globals;
+  if (vm->parser != NULL)
+    for (Compiler* compiler = vm->parser->compiler; compiler != NULL; compiler = compiler->enclosing)
+      mark(parents, OBJECT(compiler->function));
 
-  for (int i = 0; i <= table->capacity; i++) {
-    Entry* entry = &table->entries[i];
-    mark(parents, OBJECT(entry->key));
-    mark(parents, entry->value);
-  }
+  for (int i = 0; i < vm->globals.count; i++)
+    mark(parents, vm->globals.values[i]);
 
-  Table* prototypes[] = {
+  for (int i = 0; i < vm->scripts.count; i++)
+    mark(parents, OBJECT(vm->scripts.content[i]));
+
+  Table* tables[] = {
+    &vm->globals.slots,
+    &vm->numbers,
     &vm->prototypes.object.properties,
     &vm->prototypes.number.properties,
-    &vm->prototypes.string.properties
+    &vm->prototypes.string.properties,
+    &vm->prototypes.builder.properties
   };
 
-  for (int counter = 0; counter < 3; counter++) {
-    Table* prototype = prototypes[counter];
+  for (int counter = 0; counter < 6; counter++) {
+    Table* table = tables[counter];
 
-    for (int i = 0; i <= prototype->capacity; i++) {
-      Entry* entry = &prototype->entries[i];
-      mark(parents, OBJECT(entry->key));
-      mark(parents, entry->value);
-    }
+    if (parents->young == true && table->young == false)
+      continue;
+
+    mark_table(parents, table);
+
+    if (parents->young == true)
+      table->young = false;
   }
 }
 
 void traverse(VM* vm, Parents* parents) {
-  while (parents->count > 0) {
-    Object* object = parents->content[--parents->count];
+  while (parents->count > 0)
+    blacken(parents, parents->content[--parents->count]);
+}
 
-    switch (object->type) {
-      case OBJECT_UPVALUE: {
-        mark(parents, ((Upvalue*)object)->closed);
-        break;
-      }
+static void blacken(Parents* parents, Object* object) {
+  switch (object->type) {
+    case OBJECT_ROPE: {
+      Rope* rope = (Rope*)object;
+      mark(parents, OBJECT(rope->left));
+      mark(parents, OBJECT(rope->right));
+      mark(parents, OBJECT(rope->flat));
+      break;
+    }
 
-      case OBJECT_FUNCTION: {
-        Function* function = (Function*)object;
+    case OBJECT_UPVALUE: {
+      mark(parents, ((Upvalue*)object)->closed);
+      break;
+    }
 
-        mark(parents, OBJECT(function->identifier));
+    case OBJECT_FUNCTION: {
+      Function* function = (Function*)object;
 
-        Constants* constants = &function->chunk.constants;
-        
-        for (int i = 0; i < constants->count; i++)
-          mark(parents, constants->values[i]);
+      mark(parents, OBJECT(function->identifier));
 
-        break;
-      }
+      Constants* constants = &function->chunk.constants;
+      
+      for (int i = 0; i < constants->count; i++)
+        mark(parents, constants->values[i]);
 
-      case OBJECT_CLOSURE: {
-        Closure* closure = (Closure*)object;
+      Caches* caches = &function->chunk.caches;
 
-        mark(parents, OBJECT(closure->function));
+      for (int i = 0; i < caches->count; i++) {
+        Cache* cache = &caches->content[i];
 
-        for (int i = 0; i < closure->count; i++)
-          mark(parents, OBJECT(closure->upvalues[i]));
+        for (int j = 0; j < cache->count; j++) {
+          Resolution* resolution = &cache->entries[j];
 
-        break;
-      }
+          if (resolution->resolution != RESOLUTION_NATIVE)
+            mark(parents, OBJECT(resolution->shape));
 
-      case OBJECT_NATIVE_FUNCTION: {
-        mark(parents, OBJECT(((NativeFunction*)object)->identifier));
-        break;
+          mark(parents, resolution->value);
+        }
       }
 
-      case OBJECT_NATIVE_METHOD: {
-        mark(parents, OBJECT(((NativeMethod*)object)->identifier));
-        break;
-      }
+      break;
+    }
 
-      case OBJECT_CLASS: {
-        Class* class = (Class*)object;
+    case OBJECT_CLOSURE: {
+      Closure* closure = (Closure*)object;
 
-        mark(parents, OBJECT(class->identifier));
+      mark(parents, OBJECT(closure->function));
 
-        for (int i = 0; i <= class->members.capacity; i++) {
-          Entry* entry = &class->members.entries[i];
-          mark(parents, OBJECT(entry->key));
-          mark(parents, entry->value);
-        }
+      for (int i = 0; i < closure->count; i++)
+        mark(parents, OBJECT(closure->upvalues[i]));
 
-        for (int i = 0; i <= class->methods.capacity; i++) {
-          Entry* entry = &class->methods.entries[i];
-          mark(parents, OBJECT(entry->key));
-          mark(parents, entry->value);
-        }
+      break;
+    }
 
-        break;
+    case OBJECT_NATIVE_FUNCTION: {
+      mark(parents, OBJECT(((NativeFunction*)object)->identifier));
+      break;
+    }
 
-      }
+    case OBJECT_NATIVE_METHOD: {
+      mark(parents, OBJECT(((NativeMethod*)object)->identifier));
+      break;
+    }
 
-      case OBJECT_INSTANCE: {
-        Instance* instance = (Instance*)object;
+    case OBJECT_CLASS: {
+      Class* class = (Class*)object;
 
-        mark(parents, OBJECT(instance->class));
+      mark(parents, OBJECT(class->identifier));
 
-        for (int i = 0; i <= instance->fields.capacity; i++) {
-          Entry* entry = &instance->fields.entries[i];
-          mark(parents, OBJECT(entry->key));
-          mark(parents, entry->value);
-        }
+      mark_table(parents, &class->layout);
+      mark_table(parents, &class->methods);
 
-        break;
-      }
+      for (int i = 0; i < class->defaults.count; i++)
+        mark(parents, class->defaults.values[i]);
 
-      case OBJECT_BOUND: {
-        Bound* bound = (Bound*)object;
-        mark(parents, bound->receiver);
-        mark(parents, OBJECT(bound->method));
-        break;
-      }
+      break;
 
-      case OBJECT_NATIVE_BOUND: {
-        NativeBound* native_bound = (NativeBound*)object;
-        mark(parents, native_bound->receiver);
-        mark(parents, OBJECT(native_bound->method));
-        break;
-      }
+    }
+
+    case OBJECT_INSTANCE: {
+      Instance* instance = (Instance*)object;
+
+      mark(parents, OBJECT(instance->class));
+
+      for (int i = 0; i < instance->count; i++)
+        mark(parents, instance->fields[i]);
+
+      if (instance->dictionary != NULL)
+        mark_table(parents, instance->dictionary);
+
+      break;
+    }
+
+    case OBJECT_BOUND: {
+      Bound* bound = (Bound*)object;
+      mark(parents, bound->receiver);
+      mark(parents, OBJECT(bound->method));
+      break;
+    }
+
+    case OBJECT_NATIVE_BOUND: {
+      NativeBound* native_bound = (NativeBound*)object;
+      mark(parents, native_bound->receiver);
+      mark(parents, OBJECT(native_bound->method));
+      break;
     }
   }
 }
@@ -179,26 +418,30 @@ void mark(Parents* parents, Value value) {
     if (object != NULL) {
       if (object->mark == true) return;
 
-      object->mark = true;
+      if (parents->young == true && object->old == true) return;
 
-      if (object->type == OBJECT_NUMBER || object->type == OBJECT_STRING) return;
+      object->mark = true;
 
-      if (parents->capacity < parents->count + 1) {
-        parents->capacity = GROW_CAPACITY(parents->capacity);
-        parents->content = realloc(parents->content, sizeof(Object*) * parents->capacity);
-      }
+      if (object->type == OBJECT_NUMBER || object->type == OBJECT_STRING || object->type == OBJECT_BUILDER) return;
 
-      parents->content[parents->count++] = object;
+      gray(parents, object);
     }
   }
 }
 
-void sweep(VM* vm) {
-  table_clear(&vm->strings);
+void gray(Parents* parents, Object* object) {
+  if (parents->capacity < parents->count + 1) {
+    parents->capacity = GROW_CAPACITY(parents->capacity);
+    parents->content = realloc(parents->content, sizeof(Object*) * parents->capacity);
+  }
 
+  parents->content[parents->count++] = object;
+}
+
+static void sweep_list(VM* vm, Object** list) {
   Object* previous = NULL;
 
-  Object* object = vm->objects;
+  Object* object = *list;
 
   while (object != NULL) {
     if (object->mark) {
@@ -215,10 +458,59 @@ void sweep(VM* vm) {
 
     if (previous != NULL)
       previous->next = object;
-    else vm->objects = object;
+    else *list = object;
 
     free_object(vm, unreachable);
+
+    vm->statistics.freed++;
+  }
+}
+
+void sweep(VM* vm) {
+  Parents* remembered = &vm->remembered;
+
+  int count = 0;
+
+  for (int i = 0; i < remembered->count; i++)
+    if (remembered->content[i]->mark == true)
+      remembered->content[count++] = remembered->content[i];
+
+  remembered->count = count;
+
+  sweep_list(vm, &vm->objects);
+  sweep_list(vm, &vm->old);
+}
+
+void sweep_nursery(VM* vm) {
+  for (int i = 0; i < vm->remembered.count; i++)
+    vm->remembered.content[i]->remembered = false;
+
+  vm->remembered.count = 0;
+
+  sweep_list(vm, &vm->objects);
+
+  Object* object = vm->objects;
+
+  while (object != NULL) {
+    Object* next = object->next;
+
+    object->old = true;
+
+    object->next = vm->old;
+    vm->old = object;
+
+    vm->statistics.promoted++;
+
+    object = next;
   }
+
+  vm->objects = NULL;
+}
+
+void remember(VM* vm, Object* object) {
+  object->remembered = true;
+
+  gray(&vm->remembered, object);
 }
 
 void free_object(VM* vm, Object* object) {
@@ -232,11 +524,29 @@ void free_object(VM* vm, Object* object) {
 
     case OBJECT_STRING: {
       String* string = (String*)object;
+
+      // The intern table holds its strings weakly, so each one leaves it
+      // when it is freed, rather than every sweep scanning the whole table.
+      if (string->interned == true)
+        table_delete(&vm->strings, string);
+
       FREE_ARRAY(vm, char, string->content, string->length + 1);
       FREE(vm, String, object);
       break;
     }
 
+    case OBJECT_ROPE: {
+      FREE(vm, Rope, object);
+      break;
+    }
+
+    case OBJECT_BUILDER: {
+      Builder* builder = (Builder*)object;
+      FREE_ARRAY(vm, char, builder->content, builder->capacity);
+      FREE(vm, Builder, object);
+      break;
+    }
+
     case OBJECT_UPVALUE: {
       FREE(vm, Upvalue, object);
       break;
@@ -268,16 +578,22 @@ void free_object(VM* vm, Object* object) {
 
     case OBJECT_CLASS: {
       Class* class = (Class*)object;
-      free_table(&class->members);
+      free_table(&class->layout);
       free_table(&class->methods);
+      free_constants(&class->defaults);
       FREE(vm, Class, object);
       break;
     }
 
     case OBJECT_INSTANCE: {
       Instance* instance = (Instance*)object;
-      free_table(&instance->fields);
-      FREE(vm, Instance, object);
+
+      if (instance->dictionary != NULL) {
+        free_table(instance->dictionary);
+        FREE(vm, Table, instance->dictionary);
+      }
+
+      reallocate(vm, object, sizeof(Instance) + sizeof(Value) * instance->count, 0);
       break;
     } 
 
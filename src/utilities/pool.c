@@ -0,0 +1,71 @@
+#include <stdlib.h>
+
+#include "utilities/pool.h"
+
+#define SLAB_HEADER_SIZE \
+  ( (sizeof(Slab) + POOL_GRANULARITY - 1) / POOL_GRANULARITY * POOL_GRANULARITY )
+
+void initialize_pool(Pool* pool) {
+  for (int i = 0; i < POOL_CLASSES; i++)
+    pool->blocks[i] = NULL;
+
+  pool->slabs = NULL;
+
+  pool->cursor = NULL;
+  pool->end = NULL;
+}
+
+void free_pool(Pool* pool) {
+  Slab* slab = pool->slabs;
+
+  while (slab != NULL) {
+    Slab* next = slab->next;
+    free(slab);
+    slab = next;
+  }
+
+  initialize_pool(pool);
+}
+
+static void grow(Pool* pool) {
+  Slab* slab = (Slab*)malloc(POOL_SLAB_SIZE);
+
+  if (slab == NULL) exit(1);
+
+  slab->next = pool->slabs;
+  pool->slabs = slab;
+
+  pool->cursor = (char*)slab + SLAB_HEADER_SIZE;
+  pool->end = (char*)slab + POOL_SLAB_SIZE;
+}
+
+void* pool_allocate(Pool* pool, size_t size) {
+  int class = POOL_CLASS(size);
+
+  Block* block = pool->blocks[class];
+
+  if (block != NULL) {
+    pool->blocks[class] = block->next;
+    return block;
+  }
+
+  size_t rounded = (size_t)(class + 1) * POOL_GRANULARITY;
+
+  if (pool->cursor == NULL || pool->cursor + rounded > pool->end)
+    grow(pool);
+
+  void* result = pool->cursor;
+
+  pool->cursor += rounded;
+
+  return result;
+}
+
+void pool_release(Pool* pool, void* pointer, size_t size) {
+  int class = POOL_CLASS(size);
+
+  Block* block = (Block*)pointer;
+
+  block->next = pool->blocks[class];
+  pool->blocks[class] = block;
+}
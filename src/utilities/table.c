@@ -3,13 +3,18 @@
 
 #include "vm.h"
 #include "utilities/table.h"
+#include "utilities/bytes.h"
 #include "utilities/memory.h"
+#include "types/object.h"
 
 void initialize_table(Table* table, VM* vm) {
   table->count = 0;
   table->capacity = -1;
   table->entries = NULL;
 
+  table->owner = NULL;
+  table->young = false;
+
   table->vm = vm;
 }
 
@@ -17,31 +22,81 @@ void free_table(Table* table) {
   FREE_ARRAY(table->vm, Entry, table->entries, table->capacity + 1);
 }
 
+// Entries are kept in Robin Hood order: along a run of occupied slots, no
+// entry is further from its home slot than the entry after it plus one. A
+// lookup stops at the first entry that is closer to home than the probe,
+// and a deletion shifts the rest of the run back, so there are no tombstones.
+static inline uint32_t distance(Entry* entry, uint32_t index, int capacity) {
+  return (index - entry->key->hash) & capacity;
+}
+
 static Entry* find_entry(Entry* entries, int capacity, String* key) {
   uint32_t index = key->hash & capacity;
 
-  Entry* tombstone = NULL;
-
-  while(true) {
+  for (uint32_t probe = 0; ; probe++) {
     Entry* entry = &entries[index];
 
-    if (entry->key == key || entry->key == NULL)
+    if (entry->key == key)
       return entry;
 
+    if (entry->key == NULL || distance(entry, index, capacity) < probe)
+      return NULL;
+
+    index = (index + 1) & capacity;
+  }
+}
+
+static void place(Entry* entries, int capacity, String* key, Value value) {
+  uint32_t index = key->hash & capacity;
+
+  for (uint32_t probe = 0; ; probe++) {
+    Entry* entry = &entries[index];
+
     if (entry->key == NULL) {
-      if (IS_UNDEFINED(entry->value)) 
-        return tombstone != NULL ? tombstone : entry;
+      entry->key = key;
+      entry->value = value;
 
-      if (tombstone == NULL) tombstone = entry;
-    } 
-    
-    if (entry->key == key)
-      return entry;
+      return;
+    }
+
+    uint32_t existing = distance(entry, index, capacity);
+
+    if (existing < probe) {
+      Entry displaced = *entry;
+
+      entry->key = key;
+      entry->value = value;
+
+      key = displaced.key;
+      value = displaced.value;
+
+      probe = existing;
+    }
 
     index = (index + 1) & capacity;
   }
 }
 
+static void remove_entry(Table* table, uint32_t index) {
+  while (true) {
+    uint32_t next = (index + 1) & table->capacity;
+
+    Entry* following = &table->entries[next];
+
+    if (following->key == NULL || distance(following, next, table->capacity) == 0)
+      break;
+
+    table->entries[index] = *following;
+
+    index = next;
+  }
+
+  table->entries[index].key = NULL;
+  table->entries[index].value = UNDEFINED;
+
+  table->count--;
+}
+
 static void fix_capacity(Table* table, int capacity) {
   Entry* entries = ALLOCATE(table->vm, Entry, capacity + 1);
 
@@ -50,17 +105,11 @@ static void fix_capacity(Table* table, int capacity) {
     entries[i].value = UNDEFINED;
   }
 
-  table->count = 0;
-
   for (int i = 0; i <= table->capacity; i++) {
     Entry* entry = &table->entries[i];
-    if (entry->key == NULL) continue;
 
-    Entry* new = find_entry(entries, capacity, entry->key);
-    new->key = entry->key;
-    new->value = entry->value;
-
-    table->count++;
+    if (entry->key != NULL)
+      place(entries, capacity, entry->key, entry->value);
   }
 
   FREE_ARRAY(table->vm, Entry, table->entries, table->capacity + 1);
@@ -69,20 +118,44 @@ static void fix_capacity(Table* table, int capacity) {
   table->capacity = capacity;
 }
 
+// Keys are compared by identity, so a loose key is replaced by its intern.
+// Lookups only search the intern table: a string that was never interned
+// cannot be the key of any entry.
+static String* canonical(Table* table, String* key) {
+  if (key->interned == true) return key;
+
+  return table_find_string(&table->vm->strings, key->content, key->length, hashing(key->content, key->length));
+}
+
 bool table_set(Table* table, String* key, Value value) {
-  if (table->count + 1 > (table->capacity + 1) * MAX_LOAD) {
-    int capacity = GROW_CAPACITY(table->capacity + 1) - 1;
-    fix_capacity(table, capacity);
+  if (key->interned == false) {
+    push(&table->vm->stack, OBJECT(key));
+    key = intern_string(table->vm, key);
+    pop(&table->vm->stack, 1);
   }
 
-  Entry* entry = find_entry(table->entries, table->capacity, key);
+  Entry* entry = table->count != 0 ? find_entry(table->entries, table->capacity, key) : NULL;
+
+  bool new = entry == NULL;
 
-  bool new = entry->key == NULL;
+  if (new == true) {
+    if (table->count + 1 > (table->capacity + 1) * MAX_LOAD) {
+      int capacity = GROW_CAPACITY(table->capacity + 1) - 1;
+      fix_capacity(table, capacity);
+    }
 
-  if (new && IS_UNDEFINED(entry->value)) table->count++;
+    place(table->entries, table->capacity, key, value);
 
-  entry->key = key;
-  entry->value = value;
+    table->count++;
+  }
+  else entry->value = value;
+
+  if (table->owner != NULL) {
+    barrier(table->vm, table->owner, OBJECT(key));
+    barrier(table->vm, table->owner, value);
+  }
+  else if (key->object.old == false || (IS_OBJECT(value) && AS_OBJECT(value)->old == false))
+    table->young = true;
 
   return new;
 }
@@ -90,9 +163,11 @@ bool table_set(Table* table, String* key, Value value) {
 bool table_get(Table* table, String* key, Value* value) {
   if (table->count == 0) return false;
 
+  if ((key = canonical(table, key)) == NULL) return false;
+
   Entry* entry = find_entry(table->entries, table->capacity, key);
 
-  if (entry->key == NULL) return false;
+  if (entry == NULL) return false;
 
   *value = entry->value;
 
@@ -102,25 +177,17 @@ bool table_get(Table* table, String* key, Value* value) {
 bool table_delete(Table* table, String* key) {
   if (table->count == 0) return false;
 
+  if ((key = canonical(table, key)) == NULL) return false;
+
   Entry* entry = find_entry(table->entries, table->capacity, key);
 
-  if (entry->key == NULL) return false;
+  if (entry == NULL) return false;
 
-  entry->key = NULL;
-  entry->value = VOID;
+  remove_entry(table, (uint32_t)(entry - table->entries));
 
   return true;
 }
 
-void table_clear(Table* table) {
-  for (int i = 0; i <= table->capacity; i++) {
-    Entry* entry = &table->entries[i];
-
-    if (entry->key != NULL && entry->key->object.mark == false)
-      table_delete(table, entry->key);
-  }
-}
-
 void table_append(Table* from, Table* to) {
   for (int i = 0; i <= from->capacity; i++) {
     Entry* entry = &from->entries[i];
@@ -135,12 +202,12 @@ String* table_find_string(Table* table, const char* content, int length, uint32_
 
   uint32_t index = hash & table->capacity;
 
-  while (true) {
+  for (uint32_t probe = 0; ; probe++) {
     Entry* entry = &table->entries[index];
 
-    if (entry->key == NULL) 
-      if (IS_UNDEFINED(entry->value)) return NULL;
-    
+    if (entry->key == NULL || distance(entry, index, table->capacity) < probe)
+      return NULL;
+
     if (entry->key->length == length && entry->key->hash == hash && memcmp(entry->key->content, content, length) == 0)
       return entry->key;
 
@@ -148,58 +215,19 @@ String* table_find_string(Table* table, const char* content, int length, uint32_
   }
 }
 
-uint32_t hashing(const char* string, int length) {
-  uint32_t tmp, hash = length;
-
-  if (length <= 0 || string == NULL) return 0;
-
-  int rem = length & 3;
-
-  length >>= 2;
-
-  while(length > 0) {
-    hash += BITS(string);
-
-    tmp = (BITS(string + 2) << 11) ^ hash;
-
-    hash = (hash << 16) ^ tmp;
-
-    string += 2 * sizeof(uint16_t);
+void table_probes(Table* table, Probes* probes) {
+  for (int i = 0; i <= table->capacity; i++) {
+    Entry* entry = &table->entries[i];
 
-    hash += hash >> 11;
+    if (entry->key == NULL) continue;
 
-    length--;
-  }
+    int probe = (int)distance(entry, (uint32_t)i, table->capacity);
 
-  switch (rem) {
-    case 1: 
-      hash += (signed char)*string;
-      hash ^= hash << 10;
-      hash += hash >> 1;
-      break;
+    probes->entries++;
+    probes->total += probe;
 
-    case 2: 
-      hash += BITS(string);
-      hash ^= hash << 11;
-      hash += hash >> 17;
-      break;
+    if (probe > probes->longest) probes->longest = probe;
 
-    case 3: 
-      hash += BITS(string);
-      hash ^= hash << 16;
-      hash ^= ( (signed char)string[sizeof(uint16_t)] ) << 18;
-      hash += hash >> 11;
-      break;
+    probes->histogram[probe < PROBE_BUCKETS ? probe : PROBE_BUCKETS - 1]++;
   }
-
-  hash ^= hash << 3;
-  hash += hash >> 5;
-
-  hash ^= hash << 4;
-  hash += hash >> 17;
-
-  hash ^= hash << 25;
-  hash += hash >> 6;
-
-  return hash;
 }
\ No newline at end of file
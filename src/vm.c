@@ -6,7 +6,9 @@
 #include "vm.h"
 #include "compiler.h"
 #include "types/object.h"
+#include "types/number.h"
 #include "utilities/memory.h"
+#include "utilities/cache.h"
 #include "natives/functions.h"
 #include "natives/methods.h"
 
@@ -14,55 +16,169 @@
 
 #define FRAME_INITIAL_CAPACITY 16
 
-void initialize_VM(VM* vm) {
+void set_settings(Settings* settings) {
+  settings->precision = GMP_DEFAULT_PRECISION;
+  settings->numerics = NUMERICS_PRECISE;
+  settings->collector = COLLECTOR_GENERATIONAL;
+  settings->tier = TIER_STACK;
+  settings->stack = STACK_INITIAL_SIZE;
+  settings->limit = STACK_DEFAULT_LIMIT;
+  settings->disassemble = false;
+}
+
+void initialize_VM(VM* vm, Settings* settings) {
+  vm->settings = *settings;
+
   vm->objects = NULL;
+  vm->old = NULL;
+
+  vm->parser = NULL;
 
   vm->allocate = 0;
+  vm->young = 0;
 
   vm->threshold = DEFAULT_THRESHOLD;
 
-  reset_VM(vm);
+  initialize_pool(&vm->pool);
+
+  vm->remembered.count = 0;
+  vm->remembered.capacity = 0;
+  vm->remembered.content = NULL;
+
+  vm->phase = PHASE_IDLE;
+
+  vm->gray.count = 0;
+  vm->gray.capacity = 0;
+  vm->gray.content = NULL;
+  vm->gray.young = false;
+
+  vm->scripts.count = 0;
+  vm->scripts.capacity = 0;
+  vm->scripts.content = NULL;
+  vm->scripts.young = false;
+
+  vm->mappings.count = 0;
+  vm->mappings.capacity = 0;
+  vm->mappings.content = NULL;
+
+  vm->sweeping = NULL;
+  vm->survivors = NULL;
+  vm->last = NULL;
+
+  vm->statistics = (Statistics){ 0 };
+
+  vm->counters = (Counters){ 0 };
 
   initialize_prototypes(vm);
 
   initialize_table(&vm->strings, vm);
-  initialize_table(&vm->globals, vm);
+  vm->globals.count = 0;
+  vm->globals.capacity = 0;
+  vm->globals.values = NULL;
+  vm->globals.identifiers = NULL;
+
+  initialize_table(&vm->globals.slots, vm);
+  initialize_table(&vm->numbers, vm);
+
+  vm->stack.capacity = settings->stack < STACK_HEADROOM ? STACK_HEADROOM : settings->stack;
+  vm->stack.limit = settings->limit < vm->stack.capacity ? vm->stack.capacity : settings->limit;
+
+  if ((vm->stack.content = malloc(sizeof(Value) * vm->stack.capacity)) == NULL)
+    exit(1);
+
+  vm->stack.end = vm->stack.content + vm->stack.capacity;
+
+  reset_VM(vm);
+
+  vm->call.capacity = FRAME_INITIAL_CAPACITY;
+  vm->call.frames = ALLOCATE_ARRAY(vm, Frame, NULL, 0, vm->call.capacity);
 
   load_default_native_functions(vm);
   load_default_native_methods(vm);
 }
 
 void free_VM(VM* vm) {
-  Object* object = vm->objects;
+  free_table(&vm->strings);
+  initialize_table(&vm->strings, vm);
 
-  while (object != NULL) {
-    Object* next = object->next;
-    free_object(vm, object);
-    object = next;
+  Object* lists[] = { vm->objects, vm->old, vm->sweeping, vm->survivors };
+
+  for (int counter = 0; counter < 4; counter++) {
+    Object* object = lists[counter];
+
+    while (object != NULL) {
+      Object* next = object->next;
+      free_object(vm, object);
+      object = next;
+    }
   }
 
+  free(vm->remembered.content);
+  free(vm->gray.content);
+  free(vm->scripts.content);
+
+  free_mappings(vm);
+
   FREE_ARRAY(vm, Frame, vm->call.frames, vm->call.capacity);
 
+  free(vm->stack.content);
+
   free_prototypes(vm);
 
-  free_table(&vm->strings); 
-  free_table(&vm->globals); 
+  free_table(&vm->globals.slots); 
+  free_table(&vm->numbers); 
+
+  FREE_ARRAY(vm, Value, vm->globals.values, vm->globals.capacity);
+  FREE_ARRAY(vm, String*, vm->globals.identifiers, vm->globals.capacity);
+
+  free_pool(&vm->pool);
 }
 
 void reset_VM(VM* vm) {
   vm->stack.top = vm->stack.content;
 
+  vm->upvalues = NULL;
+
   vm->call.count = 0;
-  vm->call.capacity = FRAME_INITIAL_CAPACITY;
-  vm->call.frames = ALLOCATE_ARRAY(vm, Frame, (vm->call.frames = NULL), 0, vm->call.capacity);
+}
 
-  vm->upvalues = NULL;
+int global_slot(VM* vm, String* identifier) {
+  Globals* globals = &vm->globals;
+
+  Value slot;
+
+  if (table_get(&globals->slots, identifier, &slot) == true)
+    return (int)AS_INTEGER(slot);
+
+  push(&vm->stack, OBJECT(identifier));
+
+  if (globals->capacity < globals->count + 1) {
+    int capacity = globals->capacity;
+
+    globals->capacity = GROW_CAPACITY(capacity);
+
+    globals->values = ALLOCATE_ARRAY(vm, Value, globals->values, capacity, globals->capacity);
+    globals->identifiers = ALLOCATE_ARRAY(vm, String*, globals->identifiers, capacity, globals->capacity);
+  }
+
+  globals->values[globals->count] = VACANT;
+  globals->identifiers[globals->count] = identifier;
+
+  table_set(&globals->slots, identifier, INTEGER(globals->count));
+
+  pop(&vm->stack, 1);
+
+  return globals->count++;
 }
 
-static inline bool falsey(Value value) {
-  return IS_VOID(value) || 
-         IS_UNDEFINED(value) || 
-         (IS_BOOLEAN(value) && AS_BOOLEAN(value) == false);
+static inline Prototype* prototype(VM* vm, Value value) {
+  if (IS_OBJECT(value)) 
+    return AS_OBJECT(value)->prototype;
+
+  if (IS_INTEGER(value) || IS_DOUBLE(value)) 
+    return &vm->prototypes.number;
+
+  return NULL;
 }
 
 static void error(VM* vm, const char* message, ...) {
@@ -110,14 +226,29 @@ static void error(VM* vm, const char* message, ...) {
   reset_VM(vm);
 }
 
+static void settle(VM* vm, Value* values, int count) {
+  for (int i = 0; i < count; i++)
+    if (IS_ROPE(values[i]))
+      values[i] = OBJECT(flatten(vm, AS_ROPE(values[i])));
+}
+
 static bool invoke_native_method(VM* vm, Value receiver, NativeMethod* native_method, int count) {
   Handler handler;
 
   set_handler(&handler, vm);
 
+  // The receiver takes the slot of the callee, so it stays rooted, settled
+  // or not, while the native method allocates.
+  Value* slot = vm->stack.top - count - 1;
+
+  *slot = receiver;
+
+  settle(vm, vm->stack.top - count, count);
+  settle(vm, slot, 1);
+
   CMethod c_method = native_method->c_method;
 
-  Value result = c_method(receiver, count, vm->stack.top - count, &handler);
+  Value result = c_method(*slot, count, vm->stack.top - count, &handler);
 
   vm->stack.top -= count + 1;
 
@@ -129,18 +260,55 @@ static bool invoke_native_method(VM* vm, Value receiver, NativeMethod* native_me
   return !handler.error;
 }
 
+static bool grow_stack(VM* vm) {
+  Stack* stack = &vm->stack;
+
+  size_t used = stack->top - stack->content;
+
+  size_t capacity = stack->capacity;
+
+  while (capacity - used < STACK_HEADROOM && capacity < stack->limit)
+    capacity = capacity * 2 < stack->limit ? capacity * 2 : stack->limit;
+
+  if (capacity - used < STACK_HEADROOM)
+    return false;
+
+  Value* content = malloc(sizeof(Value) * capacity);
+
+  if (content == NULL) exit(1);
+
+  memcpy(content, stack->content, sizeof(Value) * used);
+
+  for (int i = 0; i < vm->call.count; i++) {
+    Frame* frame = &vm->call.frames[i];
+    frame->slots = content + (frame->slots - stack->content);
+  }
+
+  for (Upvalue* upvalue = vm->upvalues; upvalue != NULL; upvalue = upvalue->next)
+    upvalue->location = content + (upvalue->location - stack->content);
+
+  free(stack->content);
+
+  stack->content = content;
+  stack->top = content + used;
+  stack->end = content + capacity;
+  stack->capacity = capacity;
+
+  return true;
+}
+
 static bool invoke(VM* vm, Closure* closure, int count) {
   if (count != closure->function->arity) {
     error(vm, run_time_errors[EXPECT_ARGUMENTS_NUMBER], closure->function->arity, count);
     return false;
   }
 
-  if (vm->call.capacity < vm->call.count + 1) {
-    if (GROW_CAPACITY(vm->call.capacity) > INT32_MAX / (vm->call.capacity == 0 ? 1 : vm->call.capacity)) {
-      error(vm, run_time_errors[STACK_OVERFLOW]);
-      return false;
-    }
+  if (vm->stack.end - vm->stack.top < STACK_HEADROOM && grow_stack(vm) == false) {
+    error(vm, run_time_errors[STACK_OVERFLOW]);
+    return false;
+  }
 
+  if (vm->call.capacity < vm->call.count + 1) {
     int capacity = vm->call.capacity;
 
     vm->call.capacity = GROW_CAPACITY(capacity);
@@ -168,6 +336,8 @@ static bool call(VM* vm, Value value, int count) {
 
         set_handler(&handler, vm);
 
+        settle(vm, vm->stack.top - count, count);
+
         CFunction c_function = AS_NATIVE_FUNCTION(value)->c_function;
 
         Value result = c_function(count, vm->stack.top - count, &handler);
@@ -252,6 +422,8 @@ static void close(VM* vm, Value* last) {
 
     upvalue->closed = *upvalue->location;
     upvalue->location = &upvalue->closed;
+
+    barrier(vm, (Object*)upvalue, upvalue->closed);
     
     vm->upvalues = upvalue->next;
   }
@@ -287,54 +459,271 @@ static bool native_bound(VM* vm, Table table, String* property) {
   return true;
 }
 
+static void learn(VM* vm, Function* function, Cache* cache, Resolution* resolution) {
+  if (cache->megamorphic == true) return;
+
+  int index = 0;
+
+  while (index < cache->count && cache->entries[index].shape != resolution->shape)
+    index++;
+
+  if (index == CACHE_ENTRIES) {
+    cache->megamorphic = true;
+    cache->count = 0;
+
+    vm->counters.megamorphic++;
+
+    return;
+  }
+
+  if (index == cache->count) cache->count++;
+
+  cache->entries[index] = *resolution;
+
+  if (resolution->resolution != RESOLUTION_NATIVE)
+    barrier(vm, (Object*)function, OBJECT(resolution->shape));
+
+  barrier(vm, (Object*)function, resolution->value);
+}
+
+static bool resolve(VM* vm, Function* function, Cache* cache, Value receiver, String* property, Resolution* result) {
+  void* shape;
+  int version;
+
+  Instance* instance = NULL;
+
+  if (IS_INSTANCE(receiver) == true) {
+    instance = AS_INSTANCE(receiver);
+
+    if (instance->dictionary != NULL || instance->count != instance->class->defaults.count)
+      return false;
+
+    shape = instance->class;
+    version = instance->class->version;
+  }
+  else if ((shape = prototype(vm, receiver)) != NULL)
+    version = 0;
+  else return false;
+
+  if (cache->megamorphic == false) {
+    for (int i = 0; i < cache->count; i++) {
+      Resolution* resolution = &cache->entries[i];
+
+      if (resolution->shape == shape && resolution->version == version) {
+        vm->counters.hits++;
+        *result = *resolution;
+        return true;
+      }
+    }
+  }
+
+  vm->counters.misses++;
+
+  Value value;
+
+  result->shape = shape;
+  result->version = version;
+
+  if (instance != NULL) {
+    Class* class = instance->class;
+
+    if (table_get(&class->layout, property, &value) == true) {
+      result->resolution = RESOLUTION_FIELD;
+      result->slot = (int)AS_INTEGER(value);
+      result->value = VOID;
+    }
+    else if (table_get(&class->methods, property, &value) == true) {
+      result->resolution = RESOLUTION_METHOD;
+      result->slot = -1;
+      result->value = value;
+    }
+    else return false;
+  }
+  else {
+    if (table_get(&((Prototype*)shape)->properties, property, &value) == false)
+      return false;
+
+    result->resolution = RESOLUTION_NATIVE;
+    result->slot = -1;
+    result->value = value;
+  }
+
+  learn(vm, function, cache, result);
+
+  return true;
+}
+
 static Results run(VM* vm) {
   Frame* frame = &vm->call.frames[vm->call.count - 1];
 
-  #define READ_BYTE() ( *frame->ip++ )
+  uint8_t* ip = frame->ip;
+  Value* sp = vm->stack.top;
+  Value* guard = vm->stack.end - STACK_RESERVE;
+  Value* slots = frame->slots;
+  Value* constants = frame->closure->function->chunk.constants.values;
 
-  #define READ_SHORT() ( frame->ip += 2, (uint16_t)((frame->ip[-2] << 8) | frame->ip[-1]) )
+  #define STORE() ( frame->ip = ip, vm->stack.top = sp )
 
-  #define READ_CONSTANT() ( frame->closure->function->chunk.constants.values[READ_BYTE()] )
+  #define RESTORE() \
+    do { \
+      frame = &vm->call.frames[vm->call.count - 1]; \
+      ip = frame->ip; \
+      sp = vm->stack.top; \
+      guard = vm->stack.end - STACK_RESERVE; \
+      slots = frame->slots; \
+      constants = frame->closure->function->chunk.constants.values; \
+    } while (false)
+
+  // The value is computed before the stack can move, since it may read
+  // through a pointer into the stack.
+  #define PUSH(value) \
+    do { \
+      Value pushed = (value); \
+      if (sp >= guard) { \
+        STORE(); \
+        if (grow_stack(vm) == false) \
+          RUNTIME_ERROR(run_time_errors[STACK_OVERFLOW]); \
+        RESTORE(); \
+      } \
+      *sp++ = pushed; \
+    } while (false)
 
+  // Stores a result into a slot that an operand of the same instruction
+  // has just freed, which needs no check.
+  #define PUT(value) ( *sp++ = (value) )
+
+  #define POP() ( *--sp )
+
+  #define DROP(count) ( sp -= (count) )
+
+  #define PEEK(distance) ( sp[- 1 - (distance)] )
+
+  #define RUNTIME_ERROR(...) \
+    do { \
+      STORE(); \
+      error(vm, __VA_ARGS__); \
+      return INTERPRET_RUNTIME_ERROR; \
+    } while (false)
+
+  #define READ_BYTE() ( *ip++ )
+
+  #define READ_SHORT() ( ip += 2, (uint16_t)((ip[-2] << 8) | ip[-1]) )
+
+  #define READ_CONSTANT() ( constants[READ_BYTE()] )
+
+  #define READ_CONSTANT_LONG() ( constants[READ_SHORT()] )
+
+  #define READ_CACHE() ( &frame->closure->function->chunk.caches.content[READ_SHORT()] )
+
+  #ifdef COUNT_INSTRUCTIONS
+  #define COMPUTE_NEXT() do { vm->counters.instructions++; goto *jump_table[READ_BYTE()]; } while(false)
+  #else
   #define COMPUTE_NEXT() goto *jump_table[READ_BYTE()]
+  #endif
 
-  #define BINARY_OPERATION(operator, check) \
+  #define BINARY_OPERATION(operation, check) \
     do { \
-      if (check) { \
-        if (!IS_NUMBER(peek(&vm->stack, 0)) || !IS_NUMBER(peek(&vm->stack, 1))) { \
-          error(vm, run_time_errors[MUST_BE_NUMBERS]); \
-          return INTERPRET_RUNTIME_ERROR; \
+      Value right = PEEK(0); Value left = PEEK(1); \
+      if (IS_INTEGER(left) && IS_INTEGER(right)) { \
+        int64_t result; \
+        if (integer_arithmetic(operation, AS_INTEGER(left), AS_INTEGER(right), &result)) { \
+          DROP(2); \
+          PUT(INTEGER(result)); \
+          COMPUTE_NEXT(); \
         } \
       } \
-      Value right = pop(&vm->stack, 1); Value left = pop(&vm->stack, 1); \
-      mpf_t result; mpf_init(result); \
-      operator(result, AS_NUMBER(left)->content, AS_NUMBER(right)->content); \
-      push(&vm->stack, OBJECT(allocate_number_from_gmp(vm, result)) ); \
-      mpf_clear(result); \
+      if (IS_DOUBLE(left) && IS_DOUBLE(right)) { \
+        double result = double_arithmetic(operation, AS_DOUBLE(left), AS_DOUBLE(right)); \
+        DROP(2); \
+        PUT(DOUBLE(result)); \
+        COMPUTE_NEXT(); \
+      } \
+      if (check) { \
+        if (!IS_NUMBER(left) || !IS_NUMBER(right)) \
+          RUNTIME_ERROR(run_time_errors[MUST_BE_NUMBERS]); \
+      } \
+      STORE(); \
+      Value result = arithmetic(vm, operation, left, right); \
+      DROP(2); \
+      PUT(result); \
     } while(false) 
 
-  #define BINARY_COMPARISON(operator, check) \
+  #define BINARY_COMPARISON(operator, negate) \
     do { \
-      if (check) { \
-        if (IS_NUMBER(peek(&vm->stack, 0)) && IS_NUMBER(peek(&vm->stack, 1))) { \
-          Value right = pop(&vm->stack, 1); Value left = pop(&vm->stack, 1); \
-          bool comparison = mpf_cmp(AS_NUMBER(left)->content, AS_NUMBER(right)->content) operator 0; \
-          push(&vm->stack, BOOLEAN(comparison)); \
-          COMPUTE_NEXT(); \
-        } \
-        if (IS_STRING(peek(&vm->stack, 0)) && IS_STRING(peek(&vm->stack, 1))) { \
-          String* right = AS_STRING(pop(&vm->stack, 1)); String* left = AS_STRING(pop(&vm->stack, 1)); \
-          bool comparison = left->length operator right->length; \
-          if (left->length == right->length) comparison = memcmp(left->content, right->content, left->length) operator 0; \
-          push(&vm->stack, BOOLEAN(comparison)); \
+      Value right = PEEK(0); Value left = PEEK(1); \
+      if (IS_INTEGER(left) && IS_INTEGER(right)) { \
+        DROP(2); \
+        PUT(BOOLEAN((AS_INTEGER(left) operator AS_INTEGER(right)) != negate)); \
+        COMPUTE_NEXT(); \
+      } \
+      if (IS_DOUBLE(left) && IS_DOUBLE(right)) { \
+        DROP(2); \
+        PUT(BOOLEAN((AS_DOUBLE(left) operator AS_DOUBLE(right)) != negate)); \
+        COMPUTE_NEXT(); \
+      } \
+      if (IS_NUMBER(left) && IS_NUMBER(right)) { \
+        bool comparison = compare_numbers(left, right) operator 0; \
+        DROP(2); \
+        PUT(BOOLEAN(comparison != negate)); \
+        COMPUTE_NEXT(); \
+      } \
+      if (IS_ROPE(left) || IS_ROPE(right)) { \
+        STORE(); \
+        settle(vm, sp - 2, 2); \
+        right = PEEK(0); left = PEEK(1); \
+      } \
+      if (IS_STRING(left) && IS_STRING(right)) { \
+        String* first = AS_STRING(left); String* second = AS_STRING(right); \
+        bool comparison = first->length operator second->length; \
+        if (first->length == second->length) comparison = memcmp(first->content, second->content, first->length) operator 0; \
+        DROP(2); \
+        PUT(BOOLEAN(comparison != negate)); \
+        COMPUTE_NEXT(); \
+      } \
+      RUNTIME_ERROR(run_time_errors[MUST_BE_NUMBERS_OR_STRINGS]); \
+    } while(false)
+
+  #define REGISTER_OPERATION(operation, operand, fallback) \
+    do { \
+      Value left = slots[READ_BYTE()]; Value right = operand; \
+      if (IS_INTEGER(left) && IS_INTEGER(right)) { \
+        int64_t result; \
+        if (integer_arithmetic(operation, AS_INTEGER(left), AS_INTEGER(right), &result)) { \
+          PUSH(INTEGER(result)); \
           COMPUTE_NEXT(); \
         } \
       } \
-      error(vm, run_time_errors[MUST_BE_NUMBERS_OR_STRINGS]); \
-      return INTERPRET_RUNTIME_ERROR; \
+      if (IS_DOUBLE(left) && IS_DOUBLE(right)) { \
+        PUSH(DOUBLE(double_arithmetic(operation, AS_DOUBLE(left), AS_DOUBLE(right)))); \
+        COMPUTE_NEXT(); \
+      } \
+      PUSH(left); PUSH(right); \
+      goto fallback; \
     } while(false)
 
-  static void* jump_table[] = {
+  #define REGISTER_COMPARISON(operator, operand, fallback) \
+    do { \
+      Value left = slots[READ_BYTE()]; Value right = operand; \
+      if (IS_INTEGER(left) && IS_INTEGER(right)) { \
+        PUSH(BOOLEAN(AS_INTEGER(left) operator AS_INTEGER(right))); \
+        COMPUTE_NEXT(); \
+      } \
+      if (IS_DOUBLE(left) && IS_DOUBLE(right)) { \
+        PUSH(BOOLEAN(AS_DOUBLE(left) operator AS_DOUBLE(right))); \
+        COMPUTE_NEXT(); \
+      } \
+      PUSH(left); PUSH(right); \
+      goto fallback; \
+    } while(false)
+
+  #define REGISTER_FALLBACK(operand, fallback) \
+    do { \
+      Value left = slots[READ_BYTE()]; Value right = operand; \
+      PUSH(left); PUSH(right); \
+      goto fallback; \
+    } while(false)
+
+  static void* const jump_table[] = {
     FOREACH(COMPUTED)
   };
 
@@ -342,202 +731,180 @@ static Results run(VM* vm) {
 
   OP_CONSTANT: {   
     Value constant = READ_CONSTANT();
-    push(&vm->stack, constant);
+    PUSH(constant);
     COMPUTE_NEXT();
   } 
 
-  OP_TRUE: push(&vm->stack, BOOLEAN(true)); COMPUTE_NEXT();
+  OP_CONSTANT_LONG: {
+    Value constant = READ_CONSTANT_LONG();
+    PUSH(constant);
+    COMPUTE_NEXT();
+  }
+
+  OP_TRUE: PUSH(BOOLEAN(true)); COMPUTE_NEXT();
 
-  OP_FALSE: push(&vm->stack, BOOLEAN(false)); COMPUTE_NEXT();
+  OP_FALSE: PUSH(BOOLEAN(false)); COMPUTE_NEXT();
 
-  OP_VOID: push(&vm->stack, VOID); COMPUTE_NEXT();
+  OP_VOID: PUSH(VOID); COMPUTE_NEXT();
 
-  OP_UNDEFINED: push(&vm->stack, UNDEFINED); COMPUTE_NEXT();
+  OP_UNDEFINED: PUSH(UNDEFINED); COMPUTE_NEXT();
 
   OP_NEGATION: {
-    if (!IS_NUMBER(peek(&vm->stack, 0))) {
-      error(vm, run_time_errors[MUST_BE_NUMBER]);
+    Value value = PEEK(0);
 
-      return INTERPRET_RUNTIME_ERROR;
+    if (IS_INTEGER(value) && AS_INTEGER(value) != INTEGER_MIN) {
+      sp[-1] = INTEGER(-AS_INTEGER(value));
+      COMPUTE_NEXT();
     }
 
-    mpf_t result; 
-    
-    mpf_init(result);
-
-    mpf_neg(result, AS_NUMBER(pop(&vm->stack, 1))->content);
+    if (!IS_NUMBER(value))
+      RUNTIME_ERROR(run_time_errors[MUST_BE_NUMBER]);
 
-    push(&vm->stack, OBJECT(allocate_number_from_gmp(vm, result)) );
+    STORE();
 
-    mpf_clear(result);
+    sp[-1] = negation(vm, value);
 
     COMPUTE_NEXT();
   }
   
   OP_ADD: {
-    if (IS_STRING(peek(&vm->stack, 0)) && IS_STRING(peek(&vm->stack, 1))) {
-      String* right = AS_STRING(peek(&vm->stack, 0));
-      String* left = AS_STRING(peek(&vm->stack, 1));
-
-      int length = left->length + right->length;
-
-      char* content = ALLOCATE(vm, char, length + 1);
-
-      memcpy(content, left->content, left->length);
-      memcpy(content + left->length, right->content, right->length);
-
-      content[length] = '\0';
+    if (IS_TEXT(PEEK(0)) && IS_TEXT(PEEK(1))) {
+      STORE();
 
-      String* result = take_string(vm, content, length);
+      Object* result = join(vm, AS_OBJECT(PEEK(1)), AS_OBJECT(PEEK(0)));
 
-      pop(&vm->stack, 2);
+      DROP(2);
 
-      push(&vm->stack, OBJECT(result));
+      PUT(OBJECT(result));
 
       COMPUTE_NEXT();
     }
 
-    if (IS_NUMBER(peek(&vm->stack, 0)) && IS_NUMBER(peek(&vm->stack, 1))) {
-      BINARY_OPERATION(mpf_add, false);
+    if (IS_NUMBER(PEEK(0)) && IS_NUMBER(PEEK(1))) {
+      BINARY_OPERATION(ARITHMETIC_ADD, false);
 
       COMPUTE_NEXT();
     }
 
-    error(vm, run_time_errors[MUST_BE_NUMBERS_OR_STRINGS]);
-
-    return INTERPRET_RUNTIME_ERROR;
+    RUNTIME_ERROR(run_time_errors[MUST_BE_NUMBERS_OR_STRINGS]);
   }
 
-  OP_SUBTRACT: BINARY_OPERATION(mpf_sub, true); COMPUTE_NEXT();
+  OP_SUBTRACT: BINARY_OPERATION(ARITHMETIC_SUBTRACT, true); COMPUTE_NEXT();
 
-  OP_MULTIPLY: BINARY_OPERATION(mpf_mul, true); COMPUTE_NEXT();
+  OP_MULTIPLY: BINARY_OPERATION(ARITHMETIC_MULTIPLY, true); COMPUTE_NEXT();
 
   OP_DIVIDE: {
-    if (!IS_NUMBER(peek(&vm->stack, 0)) || !IS_NUMBER(peek(&vm->stack, 1))) {
-      error(vm, run_time_errors[MUST_BE_NUMBERS]);
-
-      return INTERPRET_RUNTIME_ERROR;
-    }
-
-    if (mpf_cmp_ui(AS_NUMBER(peek(&vm->stack, 0))->content, 0) == 0) {
-      error(vm, run_time_errors[CANNOT_DIVIDE_BY_ZERO]);
+    if (!IS_NUMBER(PEEK(0)) || !IS_NUMBER(PEEK(1)))
+      RUNTIME_ERROR(run_time_errors[MUST_BE_NUMBERS]);
 
-      return INTERPRET_RUNTIME_ERROR;
-    }
+    if (zero(PEEK(0)))
+      RUNTIME_ERROR(run_time_errors[CANNOT_DIVIDE_BY_ZERO]);
 
-    BINARY_OPERATION(mpf_div, false); 
+    BINARY_OPERATION(ARITHMETIC_DIVIDE, false); 
 
     COMPUTE_NEXT();
   }
 
   OP_POWER: {
-    if (!IS_NUMBER(peek(&vm->stack, 0)) || !IS_NUMBER(peek(&vm->stack, 1))) { 
-      error(vm, run_time_errors[MUST_BE_NUMBER]); 
-      return INTERPRET_RUNTIME_ERROR; 
-    } 
-
-    Value right = pop(&vm->stack, 1); 
-    Value left = pop(&vm->stack, 1); 
-
-    mpf_t result; 
-      
-    mpf_init(result); 
-
-    unsigned long exponent = (unsigned long)(mpf_get_d(AS_NUMBER(right)->content));
-
-    mpf_pow_ui(result, AS_NUMBER(left)->content, exponent);
+    if (!IS_NUMBER(PEEK(0)) || !IS_NUMBER(PEEK(1)))
+      RUNTIME_ERROR(run_time_errors[MUST_BE_NUMBER]);
 
-    push(&vm->stack, OBJECT(allocate_number_from_gmp(vm, result)) ); 
-
-    mpf_clear(result);
+    BINARY_OPERATION(ARITHMETIC_POWER, false);
 
     COMPUTE_NEXT();
   }
 
   OP_NOT: {
-    bool result = falsey(pop(&vm->stack, 1));
-    push(&vm->stack, BOOLEAN(result));
+    bool result = falsey(POP());
+    PUT(BOOLEAN(result));
     COMPUTE_NEXT();
   }
 
   OP_EQUAL: {
-    Value right = pop(&vm->stack, 1);
-    Value left = pop(&vm->stack, 1);
+    if (IS_ROPE(PEEK(0)) || IS_ROPE(PEEK(1))) {
+      STORE();
+      settle(vm, sp - 2, 2);
+    }
+
+    Value right = POP();
+    Value left = POP();
 
     bool result = equal(left, right);
 
-    push(&vm->stack, BOOLEAN(result));
+    PUT(BOOLEAN(result));
 
     COMPUTE_NEXT();
   }
 
-  OP_GREATER: BINARY_COMPARISON(>, true); COMPUTE_NEXT();
+  OP_GREATER: BINARY_COMPARISON(>, false); COMPUTE_NEXT();
 
-  OP_LESS: BINARY_COMPARISON(<, true); COMPUTE_NEXT();
+  OP_LESS: BINARY_COMPARISON(<, false); COMPUTE_NEXT();
 
   OP_GLOBAL_INITIALIZE: {
-    String* identifier = AS_STRING(READ_CONSTANT());
-    table_set(&vm->globals, identifier, peek(&vm->stack, 0));
-    pop(&vm->stack, 1);
+    uint16_t slot = READ_SHORT();
+    vm->globals.values[slot] = PEEK(0);
+    DROP(1);
 
     COMPUTE_NEXT();
   } 
 
   OP_GLOBAL_SET: {
-    String* identifier = AS_STRING(READ_CONSTANT());
+    uint16_t slot = READ_SHORT();
 
-    if (table_set(&vm->globals, identifier, peek(&vm->stack, 0))) {
-      table_delete(&vm->globals, identifier);
-      error(vm, run_time_errors[UNDEFINED_VARIABLE], identifier->content);
-      return INTERPRET_RUNTIME_ERROR;
-    }
+    if (IS_VACANT(vm->globals.values[slot]))
+      RUNTIME_ERROR(run_time_errors[UNDEFINED_VARIABLE], vm->globals.identifiers[slot]->content);
+
+    vm->globals.values[slot] = PEEK(0);
 
     COMPUTE_NEXT();
   }
 
   OP_GLOBAL_GET: {
-    String* identifier = AS_STRING(READ_CONSTANT());
+    uint16_t slot = READ_SHORT();
 
-    Value value;
+    Value value = vm->globals.values[slot];
 
-    if (table_get(&vm->globals, identifier, &value) == false) {
-      error(vm, run_time_errors[UNDEFINED_VARIABLE], identifier->content);
-      return INTERPRET_RUNTIME_ERROR;
-    }
+    if (IS_VACANT(value))
+      RUNTIME_ERROR(run_time_errors[UNDEFINED_VARIABLE], vm->globals.identifiers[slot]->content);
 
-    push(&vm->stack, value);
+    PUSH(value);
 
     COMPUTE_NEXT();
   }
 
   OP_LOCAL_SET: {
     uint8_t slot = READ_BYTE();
-    frame->slots[slot] = peek(&vm->stack, 0);
+    slots[slot] = PEEK(0);
     COMPUTE_NEXT();
   }
 
   OP_LOCAL_GET: {
     uint8_t slot = READ_BYTE();
-    push(&vm->stack, frame->slots[slot]);
+    PUSH(slots[slot]);
     COMPUTE_NEXT();
   }
 
   OP_UP_SET: {
     uint8_t slot = READ_BYTE();
-    *frame->closure->upvalues[slot]->location = peek(&vm->stack, 0);
+
+    Upvalue* upvalue = frame->closure->upvalues[slot];
+
+    *upvalue->location = PEEK(0);
+
+    barrier(vm, (Object*)upvalue, *upvalue->location);
     COMPUTE_NEXT();
   }
 
   OP_UP_GET: {
     uint8_t slot = READ_BYTE();
-    push(&vm->stack, *frame->closure->upvalues[slot]->location);
+    PUSH(*frame->closure->upvalues[slot]->location);
     COMPUTE_NEXT();
   }
 
   OP_LOOP: {
     uint16_t offset = READ_SHORT();
 
-    frame->ip = frame->ip - offset;
+    ip = ip - offset;
     
     COMPUTE_NEXT();
   }
@@ -545,9 +912,9 @@ static Results run(VM* vm) {
   OP_LOOP_CONDITIONAL: {
     uint16_t offset = READ_SHORT();
 
-    Value value = peek(&vm->stack, 0);
+    Value value = PEEK(0);
 
-    frame->ip -= (falsey(value) ? 1 : 0) * offset;
+    ip -= (falsey(value) ? 1 : 0) * offset;
     
     COMPUTE_NEXT();
   } 
@@ -555,7 +922,7 @@ static Results run(VM* vm) {
   OP_JUMP: {
     uint16_t offset = READ_SHORT();
 
-    frame->ip = frame->ip + offset;
+    ip = ip + offset;
     
     COMPUTE_NEXT();
   }
@@ -563,21 +930,21 @@ static Results run(VM* vm) {
   OP_JUMP_CONDITIONAL: {
     uint16_t offset = READ_SHORT();
 
-    Value value = peek(&vm->stack, 0);
+    Value value = PEEK(0);
 
-    frame->ip += (falsey(value) ? 1 : 0) * offset;
+    ip += (falsey(value) ? 1 : 0) * offset;
     
     COMPUTE_NEXT();
   } 
 
   OP_POP: 
-    pop(&vm->stack, 1); 
+    DROP(1); 
     COMPUTE_NEXT();
 
   OP_POP_N: {
     uint8_t count = READ_BYTE();
 
-    pop(&vm->stack, count);
+    DROP(count);
 
     COMPUTE_NEXT();
   } 
@@ -585,174 +952,269 @@ static Results run(VM* vm) {
   OP_CALL: {
     int count = READ_BYTE();
 
-    Value value = peek(&vm->stack, count);
+    Value value = PEEK(count);
+
+    STORE();
 
     if (call(vm, value, count) == false)
       return INTERPRET_RUNTIME_ERROR;
 
-    frame = &vm->call.frames[vm->call.count - 1];
+    RESTORE();
 
     COMPUTE_NEXT();
   }
 
   OP_RETURN: {
-    Value result = pop(&vm->stack, 1);
+    Value result = POP();
 
-    close(vm, frame->slots);
+    close(vm, slots);
 
     vm->call.count--;
 
     if (vm->call.count == 0) {
-      pop(&vm->stack, 1);
+      vm->stack.top = sp - 1;
       return INTERPRET_OK;
     }
 
-    vm->stack.top = frame->slots;
+    vm->stack.top = slots;
 
-    push(&vm->stack, result);
+    RESTORE();
 
-    frame = &vm->call.frames[vm->call.count - 1];
+    PUSH(result);
 
     COMPUTE_NEXT();
   }
 
   OP_CLOSURE: {
-    Function* function = AS_FUNCTION(READ_CONSTANT());
+    Function* function = AS_FUNCTION(READ_CONSTANT_LONG());
+
+    STORE();
     
     Closure* closure = new_closure(vm, function);
 
-    push(&vm->stack, OBJECT(closure));
+    PUSH(OBJECT(closure));
+
+    STORE();
 
     for (int i = 0; i < closure->count; i++) {
       uint8_t local = READ_BYTE();
       uint8_t index = READ_BYTE();
 
       if (local)
-        closure->upvalues[i] = capture(vm, frame->slots + index);
+        closure->upvalues[i] = capture(vm, slots + index);
       else closure->upvalues[i] = frame->closure->upvalues[index];
+
+      barrier(vm, (Object*)closure, OBJECT(closure->upvalues[i]));
     }
 
     COMPUTE_NEXT();
   }
 
   OP_CLOSE: {
-    close(vm, vm->stack.top - 1);
-    pop(&vm->stack, 1);
+    close(vm, sp - 1);
+    DROP(1);
     COMPUTE_NEXT();
   }
 
   OP_CLASS: {
-    String* identifier = AS_STRING(READ_CONSTANT());
+    String* identifier = AS_STRING(READ_CONSTANT_LONG());
+
+    STORE();
 
     Class* class = new_class(vm, identifier);
 
-    push(&vm->stack, OBJECT(class));
+    PUSH(OBJECT(class));
 
     COMPUTE_NEXT();
   }
 
   OP_MEMBER: {
-    Value property = peek(&vm->stack, 0);
-    Class* class = AS_CLASS(peek(&vm->stack, 1));
-    table_set(&class->members, AS_STRING(READ_CONSTANT()), property);
-    pop(&vm->stack, 1);
+    Value property = PEEK(0);
+    Class* class = AS_CLASS(PEEK(1));
+    STORE();
+    define_member(vm, class, AS_STRING(READ_CONSTANT_LONG()), property);
+    DROP(1);
     COMPUTE_NEXT();
   }
 
   OP_METHOD: {
-    Value property = peek(&vm->stack, 0);
-    Class* class = AS_CLASS(peek(&vm->stack, 1));
-    table_set(&class->methods, AS_STRING(READ_CONSTANT()), property);
-    pop(&vm->stack, 1);
+    Value property = PEEK(0);
+    Class* class = AS_CLASS(PEEK(1));
+    STORE();
+    define_method(vm, class, AS_STRING(READ_CONSTANT_LONG()), property);
+    DROP(1);
     COMPUTE_NEXT();
   }
 
   OP_PROPERTY_SET: {
-    if (IS_INSTANCE(peek(&vm->stack, 1)) == true) {
-      Instance* instance = AS_INSTANCE(peek(&vm->stack, 1));
+    if (IS_INSTANCE(PEEK(1)) == true) {
+      Instance* instance = AS_INSTANCE(PEEK(1));
+
+      String* property = AS_STRING(READ_CONSTANT_LONG());
+
+      Cache* cache = READ_CACHE();
+
+      Value value = PEEK(0);
 
-      String* property = AS_STRING(READ_CONSTANT());
+      Resolution resolution;
+
+      if (resolve(vm, frame->closure->function, cache, OBJECT(instance), property, &resolution) == true)
+        if (resolution.resolution == RESOLUTION_FIELD) {
+          instance->fields[resolution.slot] = value;
+
+          barrier(vm, (Object*)instance, value);
+
+          sp[-2] = value;
+          sp--;
+
+          COMPUTE_NEXT();
+        }
 
-      Value value = pop(&vm->stack, 1);
+      STORE();
 
-      if (table_set(&instance->fields, property, value) == false) {
-        pop(&vm->stack, 1);
-        push(&vm->stack, value);
+      bool new = instance_set(vm, instance, property, value);
+
+      DROP(1);
+
+      if (new == false) {
+        DROP(1);
+        PUT(value);
         COMPUTE_NEXT();
       }
 
+      STORE();
+
       if (bound(vm, instance->class->methods, property) == true)
         COMPUTE_NEXT();
 
-      error(vm, run_time_errors[UNDEFINED_PROPERTY], property->content);
-
-      return INTERPRET_RUNTIME_ERROR;
+      RUNTIME_ERROR(run_time_errors[UNDEFINED_PROPERTY], property->content);
     }
 
-    error(vm, run_time_errors[DONT_SUPPORT_PROPERTIES]);
-
-    return INTERPRET_RUNTIME_ERROR;
+    RUNTIME_ERROR(run_time_errors[DONT_SUPPORT_PROPERTIES]);
   }
 
   OP_PROPERTY_GET: {
-    Value receiver = peek(&vm->stack, 0);
+    Value receiver = PEEK(0);
+
+    String* property = AS_STRING(READ_CONSTANT_LONG());
+
+    Cache* cache = READ_CACHE();
 
-    String* property = AS_STRING(READ_CONSTANT());
+    Resolution resolution;
+
+    if (IS_INSTANCE(receiver) == true && resolve(vm, frame->closure->function, cache, receiver, property, &resolution) == true) {
+      if (resolution.resolution == RESOLUTION_FIELD) {
+        sp[-1] = AS_INSTANCE(receiver)->fields[resolution.slot];
+        COMPUTE_NEXT();
+      }
+
+      STORE();
+
+      Bound* bound = new_bound(vm, receiver, AS_CLOSURE(resolution.value));
+
+      sp[-1] = OBJECT(bound);
+
+      COMPUTE_NEXT();
+    }
 
     if (IS_INSTANCE(receiver) == true) {
       Instance* instance = AS_INSTANCE(receiver);
 
       Value value;
 
-      if (table_get(&instance->fields, property, &value) == true) {
-        pop(&vm->stack, 1);
-        push(&vm->stack, value);
+      if (instance_get(instance, property, &value) == true) {
+        DROP(1);
+        PUT(value);
         COMPUTE_NEXT();
       }
 
+      STORE();
+
       if (bound(vm, instance->class->methods, property) == true)
         COMPUTE_NEXT();
     }
 
-    if (IS_OBJECT(receiver) == true) {
-      Object* object = AS_OBJECT(receiver);
+    Prototype* properties = prototype(vm, receiver);
 
-      if (native_bound(vm, object->prototype->properties, property) == true)
-        COMPUTE_NEXT();
+    if (properties != NULL) {
+      STORE();
 
-      error(vm, run_time_errors[UNDEFINED_PROPERTY], property->content);
+      if (native_bound(vm, properties->properties, property) == true)
+        COMPUTE_NEXT();
 
-      return INTERPRET_RUNTIME_ERROR;
+      RUNTIME_ERROR(run_time_errors[UNDEFINED_PROPERTY], property->content);
     }
 
-    error(vm, run_time_errors[DONT_SUPPORT_PROPERTIES]);
-
-    return INTERPRET_RUNTIME_ERROR;
+    RUNTIME_ERROR(run_time_errors[DONT_SUPPORT_PROPERTIES]);
   }
 
   OP_INVOKE: {
-    String* identifier = AS_STRING(READ_CONSTANT());
+    String* identifier = AS_STRING(READ_CONSTANT_LONG());
 
     int count = READ_BYTE();
 
-    Value receiver = peek(&vm->stack, count);
+    Cache* cache = READ_CACHE();
+
+    Value receiver = PEEK(count);
+
+    STORE();
+
+    Resolution resolution;
+
+    if (resolve(vm, frame->closure->function, cache, receiver, identifier, &resolution) == true) {
+      switch (resolution.resolution) {
+        case RESOLUTION_FIELD: {
+          Value value = AS_INSTANCE(receiver)->fields[resolution.slot];
+
+          sp[- count - 1] = value;
+
+          if (call(vm, value, count) == false)
+            return INTERPRET_RUNTIME_ERROR;
+
+          break;
+        }
+
+        case RESOLUTION_METHOD: {
+          if (invoke(vm, AS_CLOSURE(resolution.value), count) == false)
+            return INTERPRET_RUNTIME_ERROR;
+
+          break;
+        }
+
+        case RESOLUTION_NATIVE: {
+          if (invoke_native_method(vm, receiver, AS_NATIVE_METHOD(resolution.value), count) == false)
+            return INTERPRET_RUNTIME_ERROR;
+
+          break;
+        }
+      }
+
+      RESTORE();
+
+      COMPUTE_NEXT();
+    }
 
     if (IS_INSTANCE(receiver) == true) {
       Instance* instance = AS_INSTANCE(receiver);
 
       Value value;
 
-      if (table_get(&instance->fields, identifier, &value) == true) {
-        vm->stack.top[- count - 1] = value;
+      if (instance_get(instance, identifier, &value) == true) {
+        sp[- count - 1] = value;
         
-        return call(vm, value, count);
+        if (call(vm, value, count) == false)
+          return INTERPRET_RUNTIME_ERROR;
+
+        RESTORE();
+
+        COMPUTE_NEXT();
       }
 
       Value method;
 
       if (table_get(&instance->class->methods, identifier, &method) == true) {
         if (invoke(vm, AS_CLOSURE(method), count) == true) {
-          frame = &vm->call.frames[vm->call.count - 1];
+          RESTORE();
 
           COMPUTE_NEXT();
         }
@@ -760,72 +1222,303 @@ static Results run(VM* vm) {
       }
     }
 
-    if (IS_OBJECT(receiver) == true) {
-      Value value;
-
-      Object* object = AS_OBJECT(receiver);
+    Prototype* properties = prototype(vm, receiver);
 
-      if (table_get(&object->prototype->properties, identifier, &value) == true) {
-        vm->stack.top[- count - 1] = value;
+    if (properties != NULL) {
+      Value value;
 
+      if (table_get(&properties->properties, identifier, &value) == true) {
         if(invoke_native_method(vm, receiver, AS_NATIVE_METHOD(value), count) == false)
           return INTERPRET_RUNTIME_ERROR;
 
+        RESTORE();
+
         COMPUTE_NEXT();
       }
 
-      error(vm, run_time_errors[UNDEFINED_METHOD], identifier->content);
-
-      return INTERPRET_RUNTIME_ERROR;
+      RUNTIME_ERROR(run_time_errors[UNDEFINED_METHOD], identifier->content);
     }
 
-    error(vm, run_time_errors[DONT_SUPPORT_METHODS]);
-
-    return INTERPRET_RUNTIME_ERROR;
+    RUNTIME_ERROR(run_time_errors[DONT_SUPPORT_METHODS]);
   }
 
   OP_INHERIT: {
-    Class* superclass = AS_CLASS(peek(&vm->stack, 1));
-    Class* subclass = AS_CLASS(peek(&vm->stack, 0));
+    Class* superclass = AS_CLASS(PEEK(1));
+    Class* subclass = AS_CLASS(PEEK(0));
+
+    STORE();
+
+    Table* layout = &superclass->layout;
+
+    for (int i = 0; i <= layout->capacity; i++) {
+      Entry* entry = &layout->entries[i];
+
+      if (entry->key != NULL)
+        define_member(vm, subclass, entry->key, superclass->defaults.values[AS_INTEGER(entry->value)]);
+    }
 
-    table_append(&superclass->members, &subclass->members);
     table_append(&superclass->methods, &subclass->methods);
 
-    pop(&vm->stack, 1);
+    subclass->version++;
+
+    DROP(1);
 
     COMPUTE_NEXT();
   }
 
   OP_SUPER: {
-    String* identifier = AS_STRING(READ_CONSTANT());
+    String* identifier = AS_STRING(READ_CONSTANT_LONG());
 
-    Class* superclass = AS_CLASS(pop(&vm->stack, 1));
+    Class* superclass = AS_CLASS(POP());
+
+    STORE();
 
     if (bound(vm, superclass->methods, identifier) == true)
       COMPUTE_NEXT();
 
-    error(vm, run_time_errors[UNDEFINED_PROPERTY], identifier->content);
+    RUNTIME_ERROR(run_time_errors[UNDEFINED_PROPERTY], identifier->content);
+  }
 
-    return INTERPRET_RUNTIME_ERROR;
+  OP_SUPER_INVOKE: {
+    String* identifier = AS_STRING(READ_CONSTANT_LONG());
+
+    int count = READ_BYTE();
+
+    Cache* cache = READ_CACHE();
+
+    Class* superclass = AS_CLASS(POP());
+
+    STORE();
+
+    Value method = UNDEFINED;
+
+    for (int i = 0; i < cache->count; i++) {
+      Resolution* resolution = &cache->entries[i];
+
+      if (resolution->shape == superclass && resolution->version == superclass->version) {
+        vm->counters.hits++;
+        method = resolution->value;
+        break;
+      }
+    }
+
+    if (IS_UNDEFINED(method) == true) {
+      if (table_get(&superclass->methods, identifier, &method) == false)
+        RUNTIME_ERROR(run_time_errors[UNDEFINED_METHOD], identifier->content);
+
+      vm->counters.misses++;
+
+      Resolution resolution = { superclass, superclass->version, RESOLUTION_METHOD, -1, method };
+
+      learn(vm, frame->closure->function, cache, &resolution);
+    }
+
+    if (invoke(vm, AS_CLOSURE(method), count) == false)
+      return INTERPRET_RUNTIME_ERROR;
+
+    RESTORE();
+
+    COMPUTE_NEXT();
+  }
+
+  OP_REGISTER_ADD: REGISTER_OPERATION(ARITHMETIC_ADD, slots[READ_BYTE()], OP_ADD);
+
+  OP_REGISTER_ADD_CONSTANT: REGISTER_OPERATION(ARITHMETIC_ADD, READ_CONSTANT(), OP_ADD);
+
+  OP_REGISTER_SUBTRACT: REGISTER_OPERATION(ARITHMETIC_SUBTRACT, slots[READ_BYTE()], OP_SUBTRACT);
+
+  OP_REGISTER_SUBTRACT_CONSTANT: REGISTER_OPERATION(ARITHMETIC_SUBTRACT, READ_CONSTANT(), OP_SUBTRACT);
+
+  OP_REGISTER_MULTIPLY: REGISTER_OPERATION(ARITHMETIC_MULTIPLY, slots[READ_BYTE()], OP_MULTIPLY);
+
+  OP_REGISTER_MULTIPLY_CONSTANT: REGISTER_OPERATION(ARITHMETIC_MULTIPLY, READ_CONSTANT(), OP_MULTIPLY);
+
+  OP_REGISTER_DIVIDE: REGISTER_FALLBACK(slots[READ_BYTE()], OP_DIVIDE);
+
+  OP_REGISTER_DIVIDE_CONSTANT: REGISTER_FALLBACK(READ_CONSTANT(), OP_DIVIDE);
+
+  OP_REGISTER_EQUAL: {
+    Value* left = &slots[READ_BYTE()];
+    Value* right = &slots[READ_BYTE()];
+
+    if (IS_ROPE(*left) || IS_ROPE(*right)) {
+      STORE();
+      settle(vm, left, 1);
+      settle(vm, right, 1);
+    }
+
+    PUSH(BOOLEAN(equal(*left, *right)));
+
+    COMPUTE_NEXT();
+  }
+
+  OP_REGISTER_EQUAL_CONSTANT: {
+    Value* left = &slots[READ_BYTE()];
+    Value right = READ_CONSTANT();
+
+    if (IS_ROPE(*left)) {
+      STORE();
+      settle(vm, left, 1);
+    }
+
+    PUSH(BOOLEAN(equal(*left, right)));
+
+    COMPUTE_NEXT();
+  }
+
+  OP_REGISTER_GREATER: REGISTER_COMPARISON(>, slots[READ_BYTE()], OP_GREATER);
+
+  OP_REGISTER_GREATER_CONSTANT: REGISTER_COMPARISON(>, READ_CONSTANT(), OP_GREATER);
+
+  OP_REGISTER_LESS: REGISTER_COMPARISON(<, slots[READ_BYTE()], OP_LESS);
+
+  OP_REGISTER_LESS_CONSTANT: REGISTER_COMPARISON(<, READ_CONSTANT(), OP_LESS);
+
+  OP_REGISTER_STORE: {
+    uint8_t slot = READ_BYTE();
+    slots[slot] = POP();
+    COMPUTE_NEXT();
+  }
+
+  OP_REGISTER_MOVE: {
+    uint8_t slot = READ_BYTE();
+    slots[slot] = slots[READ_BYTE()];
+    COMPUTE_NEXT();
+  }
+
+  OP_INCREMENT_LOCAL: {
+    uint8_t slot = READ_BYTE();
+
+    Value value = slots[slot];
+
+    if (IS_INTEGER(value) && AS_INTEGER(value) != INTEGER_MAX) {
+      slots[slot] = INTEGER(AS_INTEGER(value) + 1);
+      COMPUTE_NEXT();
+    }
+
+    if (!IS_NUMBER(value))
+      RUNTIME_ERROR(run_time_errors[MUST_BE_NUMBERS_OR_STRINGS]);
+
+    STORE();
+
+    slots[slot] = arithmetic(vm, ARITHMETIC_ADD, value, INTEGER(1));
+
+    COMPUTE_NEXT();
+  }
+
+  OP_DECREMENT_LOCAL: {
+    uint8_t slot = READ_BYTE();
+
+    Value value = slots[slot];
+
+    if (IS_INTEGER(value) && AS_INTEGER(value) != INTEGER_MIN) {
+      slots[slot] = INTEGER(AS_INTEGER(value) - 1);
+      COMPUTE_NEXT();
+    }
+
+    if (!IS_NUMBER(value))
+      RUNTIME_ERROR(run_time_errors[MUST_BE_NUMBERS]);
+
+    STORE();
+
+    slots[slot] = arithmetic(vm, ARITHMETIC_SUBTRACT, value, INTEGER(1));
+
+    COMPUTE_NEXT();
+  }
+
+  OP_NOT_EQUAL: {
+    if (IS_ROPE(PEEK(0)) || IS_ROPE(PEEK(1))) {
+      STORE();
+      settle(vm, sp - 2, 2);
+    }
+
+    Value right = POP();
+    Value left = POP();
+
+    bool result = equal(left, right);
+
+    PUT(BOOLEAN(!result));
+
+    COMPUTE_NEXT();
+  }
+
+  OP_GREATER_EQUAL: BINARY_COMPARISON(<, true); COMPUTE_NEXT();
+
+  OP_LESS_EQUAL: BINARY_COMPARISON(>, true); COMPUTE_NEXT();
+
+  OP_LESS_JUMP: {
+    uint16_t offset = READ_SHORT();
+
+    Value right = PEEK(0);
+    Value left = PEEK(1);
+
+    bool result;
+
+    if (IS_INTEGER(left) && IS_INTEGER(right))
+      result = AS_INTEGER(left) < AS_INTEGER(right);
+    else if (IS_DOUBLE(left) && IS_DOUBLE(right))
+      result = AS_DOUBLE(left) < AS_DOUBLE(right);
+    else if (IS_NUMBER(left) && IS_NUMBER(right))
+      result = compare_numbers(left, right) < 0;
+    else if (IS_TEXT(left) && IS_TEXT(right)) {
+      if (IS_ROPE(left) || IS_ROPE(right)) {
+        STORE();
+        settle(vm, sp - 2, 2);
+        right = PEEK(0); left = PEEK(1);
+      }
+
+      String* first = AS_STRING(left);
+      String* second = AS_STRING(right);
+
+      result = first->length < second->length;
+
+      if (first->length == second->length)
+        result = memcmp(first->content, second->content, first->length) < 0;
+    }
+    else {
+      RUNTIME_ERROR(run_time_errors[MUST_BE_NUMBERS_OR_STRINGS]);
+    }
+
+    sp -= 2;
+
+    ip += (result ? 0 : 1) * offset;
+
+    COMPUTE_NEXT();
+  }
+
+  OP_LOCAL_GET_PROPERTY: {
+    uint8_t slot = READ_BYTE();
+
+    PUSH(slots[slot]);
+
+    goto OP_PROPERTY_GET;
   }
 
   OP_EMPTY: COMPUTE_NEXT();
 
-  OP_EXIT: return INTERPRET_OK;
+  OP_EXIT: STORE(); return INTERPRET_OK;
 
+  #undef STORE
+  #undef RESTORE
+  #undef PUSH
+  #undef POP
+  #undef DROP
+  #undef PEEK
+  #undef RUNTIME_ERROR
   #undef READ_BYTE
   #undef READ_SHORT
   #undef READ_CONSTANT
+  #undef READ_CONSTANT_LONG
+  #undef READ_CACHE
   #undef COMPUTE_NEXT
   #undef BINARY_OPERATION
   #undef BINARY_COMPARISON
+  #undef REGISTER_OPERATION
+  #undef REGISTER_COMPARISON
+  #undef REGISTER_FALLBACK
 }
 
-Results interpret(VM* vm, const char* source) {
-  Function* function = compile(vm, source);
-
-  if (function == NULL) return INTERPRET_COMPILE_ERROR;
-
+Results execute(VM* vm, Function* function) {
   push(&vm->stack, OBJECT(function));
 
   Closure* closure = new_closure(vm, function);
@@ -835,7 +1528,16 @@ Results interpret(VM* vm, const char* source) {
   pop(&vm->stack, 1);
   push(&vm->stack, value);
 
-  invoke(vm, closure, 0);
+  if (invoke(vm, closure, 0) == false)
+    return INTERPRET_RUNTIME_ERROR;
 
   return run(vm);
+}
+
+Results interpret(VM* vm, const char* source) {
+  Function* function = compile(vm, source, strlen(source));
+
+  if (function == NULL) return INTERPRET_COMPILE_ERROR;
+
+  return execute(vm, function);
 }
\ No newline at end of file